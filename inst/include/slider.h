@@ -0,0 +1,117 @@
+#ifndef SLIDER_API_H
+#define SLIDER_API_H
+
+/*
+ * Public C API of slider
+ *
+ * Packages that list slider in `LinkingTo` can plug their own statistics into
+ * the segment tree behind `slide_sum()` and friends by describing them as a
+ * monoid: a node type with an identity, a way to append a value of `x` to a
+ * node, an associative way to append a node to another one, and a way to turn
+ * a node into a result.
+ *
+ * ```
+ * #include <slider.h>
+ *
+ * struct sum_node {
+ *   long double sum;
+ * };
+ *
+ * static void sum_identity(void* p_node) {
+ *   ((struct sum_node*) p_node)->sum = 0;
+ * }
+ * static void sum_push(void* p_node, double x) {
+ *   ((struct sum_node*) p_node)->sum += x;
+ * }
+ * static void sum_combine(void* p_left, const void* p_right) {
+ *   ((struct sum_node*) p_left)->sum += ((const struct sum_node*) p_right)->sum;
+ * }
+ * static void sum_finalize(const void* p_node, double* p_out) {
+ *   *p_out = (double) ((const struct sum_node*) p_node)->sum;
+ * }
+ *
+ * SEXP my_sum_monoid() {
+ *   struct slider_monoid monoid = {
+ *     .version = SLIDER_MONOID_VERSION,
+ *     .size = sizeof(struct sum_node),
+ *     .align = SLIDER_ALIGNOF(struct sum_node),
+ *     .identity = sum_identity,
+ *     .push = sum_push,
+ *     .combine = sum_combine,
+ *     .finalize = sum_finalize
+ *   };
+ *   return slider_new_monoid(&monoid);
+ * }
+ * ```
+ *
+ * The returned object is passed to `slide_monoid()`, `slide_index_monoid()`,
+ * and `hop_monoid()` from R.
+ *
+ * From C++, where designated initializers need C++20, the fields can be
+ * assigned one by one to a value initialized `slider_monoid`.
+ *
+ * Ranges of the tree are always aggregated from left to right, so `combine()`
+ * only needs to be associative. It may be called with `p_left` set to a node
+ * that has just been reset with `identity()`.
+ *
+ * Missing values of `x` are pushed like any other value, unless `na_rm = TRUE`
+ * is used, in which case they are skipped. The callbacks must not call back
+ * into R, they can't throw R errors.
+ */
+
+#include <Rinternals.h>
+#include <R_ext/Rdynload.h>
+#include <stddef.h>
+
+// Alignment of `type`, for the `align` field of `struct slider_monoid`.
+// `_Alignof()` is C11 and `alignof()` is C++11, so this expands to whichever
+// the compiler understands, and to the offset of `type` after a `char` in
+// older C.
+#if defined(__cplusplus)
+#define SLIDER_ALIGNOF(type) alignof(type)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define SLIDER_ALIGNOF(type) _Alignof(type)
+#else
+#define SLIDER_ALIGNOF(type) offsetof(struct { char c; type x; }, x)
+#endif
+
+// Bumped whenever fields are added to `struct slider_monoid`. Fields are only
+// ever appended, and slider accepts monoids of any version it knows about.
+#define SLIDER_MONOID_VERSION 1
+
+struct slider_monoid {
+  // Always `SLIDER_MONOID_VERSION`
+  int version;
+
+  // Size and alignment of a node, `sizeof()` and `SLIDER_ALIGNOF()` of its type
+  size_t size;
+  size_t align;
+
+  // Resets `p_node` to the node of an empty range
+  void (*identity)(void* p_node);
+
+  // Appends a value of `x` to the right of `p_node`
+  void (*push)(void* p_node, double x);
+
+  // Appends `p_right` to the right of `p_left`, in place
+  void (*combine)(void* p_left, const void* p_right);
+
+  // Writes the result of `p_node` to `p_out`
+  void (*finalize)(const void* p_node, double* p_out);
+};
+
+/*
+ * Validates `p_monoid` and wraps a copy of it in an external pointer of class
+ * `slider_monoid`, so `p_monoid` itself doesn't need to outlive the call.
+ */
+static inline SEXP slider_new_monoid(const struct slider_monoid* p_monoid) {
+  static SEXP (*fn)(const struct slider_monoid*) = NULL;
+
+  if (fn == NULL) {
+    fn = (SEXP (*)(const struct slider_monoid*)) R_GetCCallable("slider", "exp_new_monoid");
+  }
+
+  return fn(p_monoid);
+}
+
+#endif
@@ -0,0 +1,274 @@
+#include "bitmap.h"
+#include "utils.h"
+#include "align.h"
+
+typedef void (*bitmap_pack_word_fn)(const void* p_x,
+                                    R_xlen_t begin,
+                                    R_xlen_t end,
+                                    uint64_t* p_true_word,
+                                    uint64_t* p_na_word);
+
+static struct lgl_bitmap new_bitmap(SEXP x,
+                                    R_xlen_t size,
+                                    const void* p_x,
+                                    size_t elt_size,
+                                    bitmap_pack_word_fn pack_word);
+
+static void lgl_pack_word(const void* p_x, R_xlen_t begin, R_xlen_t end, uint64_t* p_true_word, uint64_t* p_na_word);
+
+// [[ include("bitmap.h") ]]
+struct lgl_bitmap new_lgl_bitmap(SEXP x) {
+  return new_bitmap(x, Rf_xlength(x), r_vec_deref_or_null(x), sizeof(int), lgl_pack_word);
+}
+
+// -----------------------------------------------------------------------------
+
+static void int_missing_pack_word(const void* p_x, R_xlen_t begin, R_xlen_t end, uint64_t* p_true_word, uint64_t* p_na_word);
+static void dbl_missing_pack_word(const void* p_x, R_xlen_t begin, R_xlen_t end, uint64_t* p_true_word, uint64_t* p_na_word);
+static void cpl_missing_pack_word(const void* p_x, R_xlen_t begin, R_xlen_t end, uint64_t* p_true_word, uint64_t* p_na_word);
+static void chr_missing_pack_word(const void* p_x, R_xlen_t begin, R_xlen_t end, uint64_t* p_true_word, uint64_t* p_na_word);
+static void raw_missing_pack_word(const void* p_x, R_xlen_t begin, R_xlen_t end, uint64_t* p_true_word, uint64_t* p_na_word);
+static void lgl_true_missing_pack_word(const void* p_x, R_xlen_t begin, R_xlen_t end, uint64_t* p_true_word, uint64_t* p_na_word);
+
+/*
+ * Only the `na` mask of the result is filled, marking the missing values of
+ * `x`. Bare atomic vectors are checked directly. Anything else, like data
+ * frames or S3 vectors, goes through `vec_equal_na()` so that missingness is
+ * defined the same way as in vctrs.
+ */
+// [[ include("bitmap.h") ]]
+struct lgl_bitmap new_missing_bitmap(SEXP x) {
+  if (!is_bare_vector(x)) {
+    SEXP missing = PROTECT(slider_vec_equal_na(x));
+    const int* p_missing = LOGICAL_RO(missing);
+
+    struct lgl_bitmap out = new_bitmap(
+      missing,
+      Rf_xlength(missing),
+      p_missing,
+      sizeof(int),
+      lgl_true_missing_pack_word
+    );
+
+    UNPROTECT(1);
+    return out;
+  }
+
+  const R_xlen_t size = Rf_xlength(x);
+
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP: return new_bitmap(x, size, r_vec_deref_or_null(x), sizeof(int), int_missing_pack_word);
+  case REALSXP: return new_bitmap(x, size, r_vec_deref_or_null(x), sizeof(double), dbl_missing_pack_word);
+  case CPLXSXP: return new_bitmap(x, size, COMPLEX(x), sizeof(Rcomplex), cpl_missing_pack_word);
+  case STRSXP: return new_bitmap(x, size, STRING_PTR_RO(x), sizeof(SEXP), chr_missing_pack_word);
+  case RAWSXP: return new_bitmap(x, size, RAW(x), sizeof(Rbyte), raw_missing_pack_word);
+  default: never_reached("new_missing_bitmap");
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+static void bitmap_pack(const struct lgl_bitmap* p_bitmap,
+                        SEXP x,
+                        const void* p_x,
+                        size_t elt_size,
+                        bitmap_pack_word_fn pack_word,
+                        uint64_t* p_true,
+                        uint64_t* p_na,
+                        uint64_t* p_true_counts,
+                        uint64_t* p_na_counts);
+
+static struct lgl_bitmap new_bitmap(SEXP x,
+                                    R_xlen_t size,
+                                    const void* p_x,
+                                    size_t elt_size,
+                                    bitmap_pack_word_fn pack_word) {
+  struct lgl_bitmap bitmap;
+
+  bitmap.size = size;
+  bitmap.n_words = (size + BITMAP_WORD_SIZE - 1) / BITMAP_WORD_SIZE;
+
+  const R_xlen_t n_words = bitmap.n_words;
+
+  // One allocation for both bitmaps and both sets of cumulative counts.
+  // The alignment of `uint64_t` always divides its size.
+  const R_xlen_t n_elements = 4 * n_words + 2;
+  bitmap.data = PROTECT(aligned_allocate(n_elements, sizeof(uint64_t), sizeof(uint64_t)));
+  uint64_t* p_data = (uint64_t*) aligned_void_deref(bitmap.data, sizeof(uint64_t));
+
+  uint64_t* p_true = p_data;
+  uint64_t* p_na = p_true + n_words;
+  uint64_t* p_true_counts = p_na + n_words;
+  uint64_t* p_na_counts = p_true_counts + n_words + 1;
+
+  bitmap_pack(&bitmap, x, p_x, elt_size, pack_word, p_true, p_na, p_true_counts, p_na_counts);
+
+  bitmap.p_true = p_true;
+  bitmap.p_na = p_na;
+  bitmap.p_true_counts = p_true_counts;
+  bitmap.p_na_counts = p_na_counts;
+
+  UNPROTECT(1);
+  return bitmap;
+}
+
+/*
+ * Packs `x` one word at a time. `x` is read through `p_x` when it is
+ * available, otherwise it is pulled in chunks so that unmaterialized ALTREP
+ * vectors are never copied in full.
+ */
+static void bitmap_pack(const struct lgl_bitmap* p_bitmap,
+                        SEXP x,
+                        const void* p_x,
+                        size_t elt_size,
+                        bitmap_pack_word_fn pack_word,
+                        uint64_t* p_true,
+                        uint64_t* p_na,
+                        uint64_t* p_true_counts,
+                        uint64_t* p_na_counts) {
+  const R_xlen_t size = p_bitmap->size;
+
+  SEXP buffer = R_NilValue;
+  void* p_buffer = NULL;
+
+  if (p_x == NULL) {
+    buffer = Rf_allocVector(RAWSXP, BITMAP_CHUNK_SIZE * elt_size);
+    p_buffer = (void*) RAW(buffer);
+  }
+  PROTECT(buffer);
+
+  uint64_t true_count = 0;
+  uint64_t na_count = 0;
+
+  for (R_xlen_t i = 0; i < size; i += BITMAP_CHUNK_SIZE) {
+    const R_xlen_t chunk_end = min_size(size, i + BITMAP_CHUNK_SIZE);
+
+    const void* p_chunk;
+    R_xlen_t offset;
+
+    if (p_x == NULL) {
+      r_vec_get_region(x, i, chunk_end - i, p_buffer);
+      p_chunk = p_buffer;
+      offset = i;
+    } else {
+      p_chunk = p_x;
+      offset = 0;
+    }
+
+    for (R_xlen_t j = i; j < chunk_end; j += BITMAP_WORD_SIZE) {
+      const R_xlen_t word_end = min_size(chunk_end, j + BITMAP_WORD_SIZE);
+
+      uint64_t true_word = 0;
+      uint64_t na_word = 0;
+
+      pack_word(p_chunk, j - offset, word_end - offset, &true_word, &na_word);
+
+      const R_xlen_t word = j / BITMAP_WORD_SIZE;
+
+      p_true[word] = true_word;
+      p_na[word] = na_word;
+
+      p_true_counts[word] = true_count;
+      p_na_counts[word] = na_count;
+
+      true_count += bitmap_popcount(true_word);
+      na_count += bitmap_popcount(na_word);
+    }
+  }
+
+  p_true_counts[p_bitmap->n_words] = true_count;
+  p_na_counts[p_bitmap->n_words] = na_count;
+
+  UNPROTECT(1);
+}
+
+// -----------------------------------------------------------------------------
+
+static void lgl_pack_word(const void* p_x,
+                          R_xlen_t begin,
+                          R_xlen_t end,
+                          uint64_t* p_true_word,
+                          uint64_t* p_na_word) {
+  const int* p_x_ = (const int*) p_x;
+
+  uint64_t true_word = 0;
+  uint64_t na_word = 0;
+
+  for (R_xlen_t i = begin; i < end; ++i) {
+    const int elt = p_x_[i];
+    const int bit = i - begin;
+
+    true_word |= (uint64_t) (elt != 0 && elt != NA_LOGICAL) << bit;
+    na_word |= (uint64_t) (elt == NA_LOGICAL) << bit;
+  }
+
+  *p_true_word = true_word;
+  *p_na_word = na_word;
+}
+
+#define PACK_MISSING_WORD(CTYPE, IS_MISSING) do {      \
+  const CTYPE* p_x_ = (const CTYPE*) p_x;              \
+                                                       \
+  uint64_t na_word = 0;                                \
+                                                       \
+  for (R_xlen_t i = begin; i < end; ++i) {             \
+    const CTYPE elt = p_x_[i];                         \
+    const int bit = i - begin;                         \
+    na_word |= (uint64_t) (IS_MISSING) << bit;         \
+  }                                                    \
+                                                       \
+  *p_na_word = na_word;                                \
+} while (0)
+
+static void int_missing_pack_word(const void* p_x,
+                                  R_xlen_t begin,
+                                  R_xlen_t end,
+                                  uint64_t* p_true_word,
+                                  uint64_t* p_na_word) {
+  PACK_MISSING_WORD(int, elt == NA_INTEGER);
+}
+
+static void dbl_missing_pack_word(const void* p_x,
+                                  R_xlen_t begin,
+                                  R_xlen_t end,
+                                  uint64_t* p_true_word,
+                                  uint64_t* p_na_word) {
+  PACK_MISSING_WORD(double, isnan(elt));
+}
+
+static void cpl_missing_pack_word(const void* p_x,
+                                  R_xlen_t begin,
+                                  R_xlen_t end,
+                                  uint64_t* p_true_word,
+                                  uint64_t* p_na_word) {
+  PACK_MISSING_WORD(Rcomplex, isnan(elt.r) || isnan(elt.i));
+}
+
+static void chr_missing_pack_word(const void* p_x,
+                                  R_xlen_t begin,
+                                  R_xlen_t end,
+                                  uint64_t* p_true_word,
+                                  uint64_t* p_na_word) {
+  PACK_MISSING_WORD(SEXP, elt == NA_STRING);
+}
+
+// Raw vectors can't be missing, the word stays empty
+static void raw_missing_pack_word(const void* p_x,
+                                  R_xlen_t begin,
+                                  R_xlen_t end,
+                                  uint64_t* p_true_word,
+                                  uint64_t* p_na_word) {
+  *p_na_word = 0;
+}
+
+// For the result of `vec_equal_na()`, where `TRUE` marks a missing value
+static void lgl_true_missing_pack_word(const void* p_x,
+                                       R_xlen_t begin,
+                                       R_xlen_t end,
+                                       uint64_t* p_true_word,
+                                       uint64_t* p_na_word) {
+  PACK_MISSING_WORD(int, elt == 1);
+}
+
+#undef PACK_MISSING_WORD
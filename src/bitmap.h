@@ -0,0 +1,175 @@
+#ifndef SLIDER_BITMAP
+#define SLIDER_BITMAP
+
+#include "slider.h"
+
+#define BITMAP_WORD_SIZE 64
+
+// Number of logical values pulled at once when `x` doesn't have a data pointer
+// (i.e. unmaterialized ALTREP vectors). Must be a multiple of the word size.
+#define BITMAP_CHUNK_SIZE 4096
+
+/*
+ * A logical vector packed into two bitmaps, one marking the `TRUE` values and
+ * one marking the `NA` values. Alongside the words, we store the number of set
+ * bits in all of the words before each one. This lets us count the `TRUE` or
+ * `NA` values in any window in constant time, with a single popcount of the
+ * partial word at each end of the window.
+ *
+ * `p_true_counts` and `p_na_counts` have `n_words + 1` elements, the last
+ * one holding the total count.
+ */
+struct lgl_bitmap {
+  SEXP data;
+
+  const uint64_t* p_true;
+  const uint64_t* p_na;
+
+  const uint64_t* p_true_counts;
+  const uint64_t* p_na_counts;
+
+  R_xlen_t size;
+  R_xlen_t n_words;
+};
+
+#define PROTECT_LGL_BITMAP(p_bitmap, p_n) do {  \
+  PROTECT((p_bitmap)->data);                    \
+  *(p_n) += 1;                                  \
+} while(0)
+
+
+struct lgl_bitmap new_lgl_bitmap(SEXP x);
+struct lgl_bitmap new_missing_bitmap(SEXP x);
+
+// -----------------------------------------------------------------------------
+
+static inline int bitmap_popcount(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & UINT64_C(0x5555555555555555));
+  x = (x & UINT64_C(0x3333333333333333)) + ((x >> 2) & UINT64_C(0x3333333333333333));
+  x = (x + (x >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+  return (int) ((x * UINT64_C(0x0101010101010101)) >> 56);
+#endif
+}
+
+// Number of set bits in the first `n` positions of the bitmap
+static inline uint64_t bitmap_prefix_count(const uint64_t* p_words,
+                                           const uint64_t* p_counts,
+                                           R_xlen_t n) {
+  const R_xlen_t word = n / BITMAP_WORD_SIZE;
+  const int bit = n % BITMAP_WORD_SIZE;
+
+  uint64_t out = p_counts[word];
+
+  // Avoid touching `p_words[n_words]` when `n` is on the last word boundary
+  if (bit) {
+    const uint64_t mask = (UINT64_C(1) << bit) - 1;
+    out += bitmap_popcount(p_words[word] & mask);
+  }
+
+  return out;
+}
+
+static inline uint64_t lgl_bitmap_count_true(const struct lgl_bitmap* p_bitmap,
+                                             R_xlen_t begin,
+                                             R_xlen_t end) {
+  const uint64_t* p_words = p_bitmap->p_true;
+  const uint64_t* p_counts = p_bitmap->p_true_counts;
+  return bitmap_prefix_count(p_words, p_counts, end) - bitmap_prefix_count(p_words, p_counts, begin);
+}
+
+static inline uint64_t lgl_bitmap_count_na(const struct lgl_bitmap* p_bitmap,
+                                           R_xlen_t begin,
+                                           R_xlen_t end) {
+  const uint64_t* p_words = p_bitmap->p_na;
+  const uint64_t* p_counts = p_bitmap->p_na_counts;
+  return bitmap_prefix_count(p_words, p_counts, end) - bitmap_prefix_count(p_words, p_counts, begin);
+}
+
+static inline bool lgl_bitmap_is_na(const struct lgl_bitmap* p_bitmap, R_xlen_t i) {
+  const uint64_t word = p_bitmap->p_na[i / BITMAP_WORD_SIZE];
+  return (word >> (i % BITMAP_WORD_SIZE)) & 1;
+}
+
+// -----------------------------------------------------------------------------
+
+typedef int (*lgl_bitmap_summary_fn)(const struct lgl_bitmap* p_bitmap,
+                                     R_xlen_t begin,
+                                     R_xlen_t end,
+                                     bool na_rm);
+
+static inline int lgl_bitmap_all(const struct lgl_bitmap* p_bitmap,
+                                 R_xlen_t begin,
+                                 R_xlen_t end,
+                                 bool na_rm) {
+  const uint64_t n_true = lgl_bitmap_count_true(p_bitmap, begin, end);
+  const uint64_t n_na = lgl_bitmap_count_na(p_bitmap, begin, end);
+  const uint64_t n_false = (uint64_t) (end - begin) - n_true - n_na;
+
+  // FALSE-ness overrides any potential NAs
+  if (n_false) {
+    return 0;
+  }
+
+  if (n_na && !na_rm) {
+    return NA_LOGICAL;
+  }
+
+  return 1;
+}
+
+static inline int lgl_bitmap_any(const struct lgl_bitmap* p_bitmap,
+                                 R_xlen_t begin,
+                                 R_xlen_t end,
+                                 bool na_rm) {
+  // TRUE-ness overrides any potential NAs
+  if (lgl_bitmap_count_true(p_bitmap, begin, end)) {
+    return 1;
+  }
+
+  if (!na_rm && lgl_bitmap_count_na(p_bitmap, begin, end)) {
+    return NA_LOGICAL;
+  }
+
+  return 0;
+}
+
+static inline int lgl_bitmap_count(const struct lgl_bitmap* p_bitmap,
+                                   R_xlen_t begin,
+                                   R_xlen_t end,
+                                   bool na_rm) {
+  if (!na_rm && lgl_bitmap_count_na(p_bitmap, begin, end)) {
+    return NA_INTEGER;
+  }
+
+  const uint64_t n_true = lgl_bitmap_count_true(p_bitmap, begin, end);
+
+  // Only possible with long vectors. Matches the integer overflow of `sum()`.
+  if (n_true > INT_MAX) {
+    return NA_INTEGER;
+  }
+
+  return (int) n_true;
+}
+
+// For bitmaps from `new_missing_bitmap()`, `na_rm` is unused
+
+static inline int lgl_bitmap_n_missing(const struct lgl_bitmap* p_bitmap,
+                                       R_xlen_t begin,
+                                       R_xlen_t end,
+                                       bool na_rm) {
+  const uint64_t n = lgl_bitmap_count_na(p_bitmap, begin, end);
+  return n > INT_MAX ? NA_INTEGER : (int) n;
+}
+
+static inline int lgl_bitmap_n_complete(const struct lgl_bitmap* p_bitmap,
+                                        R_xlen_t begin,
+                                        R_xlen_t end,
+                                        bool na_rm) {
+  const uint64_t n = (uint64_t) (end - begin) - lgl_bitmap_count_na(p_bitmap, begin, end);
+  return n > INT_MAX ? NA_INTEGER : (int) n;
+}
+
+#endif
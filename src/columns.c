@@ -0,0 +1,121 @@
+#include "slider.h"
+#include "columns.h"
+#include "utils.h"
+
+// -----------------------------------------------------------------------------
+
+// Objects, like a matrix of dates, still go through `vec_cast()` as a whole
+// so they error as before
+static inline bool is_columns_matrix(SEXP x) {
+  if (OBJECT(x)) {
+    return false;
+  }
+
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP: break;
+  default: return false;
+  }
+
+  SEXP dim = Rf_getAttrib(x, R_DimSymbol);
+  return dim != R_NilValue && Rf_xlength(dim) == 2;
+}
+
+static inline bool is_columns_data_frame(SEXP x) {
+  return TYPEOF(x) == VECSXP && Rf_inherits(x, "data.frame");
+}
+
+static inline R_xlen_t columns_matrix_n_row(SEXP x) {
+  return INTEGER_RO(Rf_getAttrib(x, R_DimSymbol))[0];
+}
+
+static inline void* columns_deref(SEXP x, R_xlen_t offset) {
+  switch (TYPEOF(x)) {
+  case LGLSXP: return LOGICAL(x) + offset;
+  case INTSXP: return INTEGER(x) + offset;
+  case REALSXP: return REAL(x) + offset;
+  default: never_reached("columns_deref");
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+// [[ include("columns.h") ]]
+bool is_columns(SEXP x) {
+  return is_columns_matrix(x) || is_columns_data_frame(x);
+}
+
+// [[ include("columns.h") ]]
+R_xlen_t columns_n(SEXP x) {
+  if (is_columns_matrix(x)) {
+    return INTEGER_RO(Rf_getAttrib(x, R_DimSymbol))[1];
+  }
+
+  if (is_columns_data_frame(x)) {
+    return Rf_xlength(x);
+  }
+
+  return 1;
+}
+
+// [[ include("columns.h") ]]
+SEXP columns_init(SEXP x, SEXPTYPE type) {
+  if (is_columns_matrix(x)) {
+    const int n_row = (int) columns_matrix_n_row(x);
+    const int n_col = (int) columns_n(x);
+
+    SEXP out = PROTECT(Rf_allocMatrix(type, n_row, n_col));
+    Rf_setAttrib(out, R_DimNamesSymbol, Rf_getAttrib(x, R_DimNamesSymbol));
+
+    UNPROTECT(1);
+    return out;
+  }
+
+  // Keeps the class and row names of `x`, the columns are replaced one by one
+  if (is_columns_data_frame(x)) {
+    return Rf_shallow_duplicate(x);
+  }
+
+  return Rf_allocVector(VECSXP, 1);
+}
+
+/*
+ * Matrix columns are copied out in full. They are contiguous in `x`, so this
+ * is a single copy of a region, and the copy is then read by one summary at
+ * a time rather than interleaving the columns.
+ */
+// [[ include("columns.h") ]]
+SEXP columns_get(SEXP x, R_xlen_t j) {
+  if (is_columns_matrix(x)) {
+    const R_xlen_t n_row = columns_matrix_n_row(x);
+
+    SEXP out = PROTECT(Rf_allocVector(TYPEOF(x), n_row));
+    r_vec_get_region(x, j * n_row, n_row, columns_deref(out, 0));
+
+    UNPROTECT(1);
+    return out;
+  }
+
+  if (is_columns_data_frame(x)) {
+    return VECTOR_ELT(x, j);
+  }
+
+  return x;
+}
+
+// [[ include("columns.h") ]]
+void columns_set(SEXP x, SEXP out, R_xlen_t j, SEXP column) {
+  if (is_columns_matrix(x)) {
+    const R_xlen_t n_row = columns_matrix_n_row(x);
+    r_vec_get_region(column, 0, n_row, columns_deref(out, j * n_row));
+    return;
+  }
+
+  SET_VECTOR_ELT(out, j, column);
+}
+
+// [[ include("columns.h") ]]
+SEXP columns_finalize(SEXP x, SEXP out) {
+  return is_columns(x) ? out : VECTOR_ELT(out, 0);
+}
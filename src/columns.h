@@ -0,0 +1,30 @@
+#ifndef SLIDER_COLUMNS_H
+#define SLIDER_COLUMNS_H
+
+#include "slider.h"
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Matrices of logicals, integers, or doubles, and data frames, are summarized
+ * column by column. The windows only depend on the rows, so they are located
+ * once and shared by all of the columns. Any other `x` is a single column of
+ * its own.
+ *
+ * `columns_init()` allocates the result, a matrix of `type` with the
+ * dimnames of `x`, or a data frame with the attributes of `x`.
+ * `columns_get()` extracts column `j` of `x`, and `columns_set()` stores the
+ * summary of column `j` in the result. `columns_finalize()` returns the
+ * result, unwrapping it when `x` is a single column.
+ */
+bool is_columns(SEXP x);
+
+R_xlen_t columns_n(SEXP x);
+
+SEXP columns_init(SEXP x, SEXPTYPE type);
+SEXP columns_get(SEXP x, R_xlen_t j);
+void columns_set(SEXP x, SEXP out, R_xlen_t j, SEXP column);
+SEXP columns_finalize(SEXP x, SEXP out);
+
+// -----------------------------------------------------------------------------
+#endif
@@ -0,0 +1,153 @@
+#include "slider.h"
+#include "group.h"
+#include "slider-vctrs.h"
+#include "utils.h"
+
+// -----------------------------------------------------------------------------
+
+// [[ include("group.h") ]]
+struct group_info new_group_info(SEXP sizes, SEXP order) {
+  struct group_info groups;
+
+  groups.sizes = sizes;
+  groups.order = order;
+
+  if (sizes == R_NilValue) {
+    groups.p_sizes = NULL;
+    groups.n = 1;
+  } else {
+    groups.p_sizes = INTEGER_RO(sizes);
+    groups.n = Rf_xlength(sizes);
+  }
+
+  groups.p_order = (order == R_NilValue) ? NULL : INTEGER_RO(order);
+
+  return groups;
+}
+
+/*
+ * Groups the `size` rows by the values of `by`, with `vec_group_id()`. Its
+ * ids are numbered by first appearance, so the groups are contiguous exactly
+ * when the ids never decrease. Otherwise, the rows are reordered with a
+ * counting sort on the ids, which is stable.
+ */
+// [[ include("group.h") ]]
+struct group_info new_group_info_by(SEXP by, R_xlen_t size, const char* by_arg) {
+  int n_prot = 0;
+
+  const R_xlen_t by_size = vec_size(by);
+
+  if (by_size != size) {
+    Rf_errorcall(
+      R_NilValue,
+      "`%s` must have size %i, the size of the input, not %i.",
+      by_arg,
+      (int) size,
+      (int) by_size
+    );
+  }
+
+  SEXP ids = PROTECT_N(slider_vec_group_id(by), &n_prot);
+  const int* p_ids = INTEGER_RO(ids);
+
+  int n_groups = 0;
+  bool contiguous = true;
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    const int id = p_ids[i];
+
+    if (id < n_groups) {
+      contiguous = false;
+    } else {
+      n_groups = id;
+    }
+  }
+
+  SEXP sizes = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &n_prot);
+  int* p_sizes = INTEGER(sizes);
+  memset(p_sizes, 0, n_groups * sizeof(int));
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    ++p_sizes[p_ids[i] - 1];
+  }
+
+  SEXP order = R_NilValue;
+
+  if (!contiguous) {
+    order = PROTECT_N(Rf_allocVector(INTSXP, size), &n_prot);
+    int* p_order = INTEGER(order);
+
+    int* p_next = (int*) R_alloc(n_groups, sizeof(int));
+    int next = 0;
+
+    for (int group = 0; group < n_groups; ++group) {
+      p_next[group] = next;
+      next += p_sizes[group];
+    }
+
+    for (R_xlen_t i = 0; i < size; ++i) {
+      p_order[p_next[p_ids[i] - 1]++] = (int) i + 1;
+    }
+  }
+
+  struct group_info groups = new_group_info(sizes, order);
+
+  UNPROTECT(n_prot);
+  return groups;
+}
+
+// -----------------------------------------------------------------------------
+
+// Reorders the rows of `x` so that each group is contiguous
+// [[ include("group.h") ]]
+SEXP group_info_slice(const struct group_info* p_groups, SEXP x) {
+  if (p_groups->order == R_NilValue) {
+    return x;
+  }
+
+  return vec_slice_impl(x, p_groups->order);
+}
+
+// Puts the rows of `x`, which are ordered like the output of
+// `group_info_slice()`, back in their original order
+// [[ include("group.h") ]]
+SEXP group_info_restore(const struct group_info* p_groups, SEXP x) {
+  if (p_groups->order == R_NilValue) {
+    return x;
+  }
+
+  const R_xlen_t size = Rf_xlength(p_groups->order);
+
+  SEXP inverse = PROTECT(Rf_allocVector(INTSXP, size));
+  int* p_inverse = INTEGER(inverse);
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    p_inverse[p_groups->p_order[i] - 1] = (int) i + 1;
+  }
+
+  SEXP out = vec_slice_impl(x, inverse);
+
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+// For the index functions, which reorder their inputs on the R side
+// [[ register() ]]
+SEXP slider_group_info(SEXP by, SEXP size, SEXP by_arg) {
+  const char* c_by_arg = CHAR(STRING_ELT(by_arg, 0));
+  struct group_info groups = new_group_info_by(by, r_scalar_int_get(size), c_by_arg);
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(out, 0, groups.sizes);
+  SET_VECTOR_ELT(out, 1, groups.order);
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 2));
+  SET_STRING_ELT(names, 0, Rf_mkChar("sizes"));
+  SET_STRING_ELT(names, 1, Rf_mkChar("order"));
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  UNPROTECT(2);
+  return out;
+}
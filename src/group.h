@@ -0,0 +1,54 @@
+#ifndef SLIDER_GROUP_H
+#define SLIDER_GROUP_H
+
+#include "slider.h"
+
+// -----------------------------------------------------------------------------
+
+/*
+ * The groups of rows that windows are confined to when sliding by group.
+ *
+ * The rows are first reordered so that each group is contiguous, keeping
+ * their original order within a group. `order` holds the 1-based locations
+ * of that reordering, or is `NULL` when the groups already are contiguous.
+ * `sizes` holds the size of each group, in the reordered rows.
+ *
+ * Without groups, `sizes` is `NULL` and the whole vector is a single group.
+ */
+struct group_info {
+  SEXP sizes;
+  SEXP order;
+  const int* p_sizes;
+  const int* p_order;
+  R_xlen_t n;
+};
+
+#define PROTECT_GROUP_INFO(groups, n) do { \
+  PROTECT((groups)->sizes);                \
+  PROTECT((groups)->order);                \
+  *n += 2;                                 \
+} while (0)
+
+struct group_info new_group_info(SEXP sizes, SEXP order);
+struct group_info new_group_info_by(SEXP by, R_xlen_t size, const char* by_arg);
+
+SEXP group_info_slice(const struct group_info* p_groups, SEXP x);
+SEXP group_info_restore(const struct group_info* p_groups, SEXP x);
+
+static inline R_xlen_t group_info_size(const struct group_info* p_groups,
+                                       R_xlen_t group,
+                                       R_xlen_t size) {
+  return p_groups->p_sizes == NULL ? size : p_groups->p_sizes[group];
+}
+
+// Maps a 1-based location in the reordered rows back to the original rows
+static inline int group_info_location(const struct group_info* p_groups, int loc) {
+  if (p_groups->p_order == NULL || loc == NA_INTEGER) {
+    return loc;
+  }
+
+  return p_groups->p_order[loc - 1];
+}
+
+// -----------------------------------------------------------------------------
+#endif
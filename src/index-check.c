@@ -0,0 +1,224 @@
+#include "slider.h"
+#include "group.h"
+#include "slider-vctrs.h"
+#include "utils.h"
+
+/*
+ * Fused checks of `i` and of the endpoints generated from it by `.before` and
+ * `.after`. They work on the compare proxy of the vector, and are only used
+ * when that proxy is an atomic vector. Each check is done in a single pass
+ * over the proxy, which for `i` is the same pass that groups its peers. On
+ * failure, the R side reruns the equivalent R level checks to signal the same
+ * condition, with every problematic location, as the slow path.
+ */
+
+// Uses the sortedness hint of ALTREP vectors, like `1:n`, to skip checking
+// input that is already known to be ascending and free of missing values
+static bool is_known_ascending(SEXP x) {
+#if (R_VERSION >= R_Version(3, 5, 0))
+  switch (TYPEOF(x)) {
+  case INTSXP: {
+    const int sorted = INTEGER_IS_SORTED(x);
+    return (sorted == SORTED_INCR || sorted == SORTED_INCR_NA_1st) && INTEGER_NO_NA(x);
+  }
+  case REALSXP: {
+    const int sorted = REAL_IS_SORTED(x);
+    return (sorted == SORTED_INCR || sorted == SORTED_INCR_NA_1st) && REAL_NO_NA(x);
+  }
+  default: {
+    return false;
+  }
+  }
+#else
+  return false;
+#endif
+}
+
+static inline bool int_is_missing(int x) {
+  return x == NA_INTEGER;
+}
+static inline bool dbl_is_missing(double x) {
+  return isnan(x);
+}
+
+// Returns `false` as soon as an element is missing or smaller than the one
+// before it in its group
+#define IS_ASCENDING(CTYPE, CONST_DEREF, IS_MISSING) do {                             \
+  const CTYPE* p_x = CONST_DEREF(x);                                                  \
+  R_xlen_t group_start = 0;                                                           \
+                                                                                      \
+  for (R_xlen_t group = 0; group < p_groups->n; ++group) {                            \
+    const R_xlen_t group_stop = group_start + group_info_size(p_groups, group, size); \
+                                                                                      \
+    for (R_xlen_t i = group_start; i < group_stop; ++i) {                             \
+      if (IS_MISSING(p_x[i])) {                                                       \
+        return false;                                                                 \
+      }                                                                               \
+      if (i > group_start && p_x[i] < p_x[i - 1]) {                                   \
+        return false;                                                                 \
+      }                                                                               \
+    }                                                                                 \
+                                                                                      \
+    group_start = group_stop;                                                         \
+  }                                                                                   \
+                                                                                      \
+  return true;                                                                        \
+} while (0)
+
+static bool is_ascending(SEXP x, const struct group_info* p_groups) {
+  const R_xlen_t size = Rf_xlength(x);
+
+  // Ascending overall implies ascending within each group
+  if (is_known_ascending(x)) {
+    return true;
+  }
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: IS_ASCENDING(int, LOGICAL_RO, int_is_missing);
+  case INTSXP: IS_ASCENDING(int, INTEGER_RO, int_is_missing);
+  case REALSXP: IS_ASCENDING(double, REAL_RO, dbl_is_missing);
+  default: never_reached("is_ascending");
+  }
+}
+
+#undef IS_ASCENDING
+
+// Run length encodes `x`, while checking that it is ascending within its
+// groups and free of missing values, like `is_ascending()`. Runs never span
+// two groups. Returns the number of runs, with their sizes in `p_sizes` and
+// their 1-based starting locations in `p_locs`, or `-1` when a check fails.
+// The number of runs of each group is written to `p_group_runs`, unless it is
+// `NULL`.
+#define FILL_RUNS(CTYPE, CONST_DEREF, IS_MISSING) do {                                \
+  const CTYPE* p_x = CONST_DEREF(x);                                                  \
+  R_xlen_t group_start = 0;                                                           \
+                                                                                      \
+  for (R_xlen_t group = 0; group < p_groups->n; ++group) {                            \
+    const R_xlen_t group_stop = group_start + group_info_size(p_groups, group, size); \
+    const R_xlen_t group_first_run = n_runs;                                          \
+                                                                                      \
+    for (R_xlen_t i = group_start; i < group_stop; ++i) {                             \
+      if (check) {                                                                    \
+        if (IS_MISSING(p_x[i])) {                                                     \
+          return -1;                                                                  \
+        }                                                                             \
+        if (i > group_start && p_x[i] < p_x[i - 1]) {                                 \
+          return -1;                                                                  \
+        }                                                                             \
+      }                                                                               \
+                                                                                      \
+      if (i > group_start && p_x[i] == p_x[i - 1]) {                                  \
+        ++p_sizes[n_runs - 1];                                                        \
+        continue;                                                                     \
+      }                                                                               \
+                                                                                      \
+      p_sizes[n_runs] = 1;                                                            \
+      p_locs[n_runs] = i + 1;                                                         \
+      ++n_runs;                                                                       \
+    }                                                                                 \
+                                                                                      \
+    if (p_group_runs != NULL) {                                                       \
+      p_group_runs[group] = n_runs - group_first_run;                                 \
+    }                                                                                 \
+                                                                                      \
+    group_start = group_stop;                                                         \
+  }                                                                                   \
+} while (0)
+
+static R_xlen_t fill_runs(SEXP x,
+                          const struct group_info* p_groups,
+                          int* p_sizes,
+                          int* p_locs,
+                          int* p_group_runs) {
+  const R_xlen_t size = Rf_xlength(x);
+  R_xlen_t n_runs = 0;
+
+  // Ascending overall implies ascending within each group
+  const bool check = !is_known_ascending(x);
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: FILL_RUNS(int, LOGICAL_RO, int_is_missing); break;
+  case INTSXP: FILL_RUNS(int, INTEGER_RO, int_is_missing); break;
+  case REALSXP: FILL_RUNS(double, REAL_RO, dbl_is_missing); break;
+  default: never_reached("fill_runs");
+  }
+
+  return n_runs;
+}
+
+#undef FILL_RUNS
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Checks that `i` is ascending within each of the groups of `group_sizes`,
+ * and free of missing values, then splits it into its unique values and the
+ * sizes of their groups of peers, like `vec_unrep()`. The `key` is `i` itself
+ * when all of its values are unique. When sliding by group, the number of
+ * unique values of each group is returned as `group_sizes`.
+ *
+ * Returns `NULL` when a check fails.
+ */
+// [[ register() ]]
+SEXP slider_index_peers(SEXP i, SEXP i_proxy, SEXP group_sizes) {
+  int n_prot = 0;
+
+  const struct group_info groups = new_group_info(group_sizes, R_NilValue);
+
+  const R_xlen_t size = Rf_xlength(i_proxy);
+
+  SEXP sizes = PROTECT_N(Rf_allocVector(INTSXP, size), &n_prot);
+  SEXP locs = PROTECT_N(Rf_allocVector(INTSXP, size), &n_prot);
+
+  SEXP key_group_sizes = R_NilValue;
+  int* p_key_group_sizes = NULL;
+
+  if (group_sizes != R_NilValue) {
+    key_group_sizes = PROTECT_N(Rf_allocVector(INTSXP, groups.n), &n_prot);
+    p_key_group_sizes = INTEGER(key_group_sizes);
+  }
+
+  const R_xlen_t n_runs = fill_runs(i_proxy, &groups, INTEGER(sizes), INTEGER(locs), p_key_group_sizes);
+
+  if (n_runs < 0) {
+    UNPROTECT(n_prot);
+    return R_NilValue;
+  }
+
+  SEXP key = i;
+
+  if (n_runs != size) {
+    sizes = PROTECT_N(Rf_xlengthgets(sizes, n_runs), &n_prot);
+    locs = PROTECT_N(Rf_xlengthgets(locs, n_runs), &n_prot);
+    key = PROTECT_N(vec_slice_impl(i, locs), &n_prot);
+  }
+
+  SEXP out = PROTECT_N(Rf_allocVector(VECSXP, 3), &n_prot);
+  SET_VECTOR_ELT(out, 0, key);
+  SET_VECTOR_ELT(out, 1, sizes);
+  SET_VECTOR_ELT(out, 2, key_group_sizes);
+
+  SEXP names = PROTECT_N(Rf_allocVector(STRSXP, 3), &n_prot);
+  SET_STRING_ELT(names, 0, Rf_mkChar("key"));
+  SET_STRING_ELT(names, 1, Rf_mkChar("times"));
+  SET_STRING_ELT(names, 2, Rf_mkChar("group_sizes"));
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+/*
+ * Checks that generated endpoints have size `size`, and are ascending within
+ * each of the groups of `group_sizes`, and free of missing values.
+ */
+// [[ register() ]]
+SEXP slider_check_generated_endpoints(SEXP endpoints_proxy, SEXP size, SEXP group_sizes) {
+  const struct group_info groups = new_group_info(group_sizes, R_NilValue);
+
+  const bool ok =
+    Rf_xlength(endpoints_proxy) == r_scalar_int_get(size) &&
+    is_ascending(endpoints_proxy, &groups);
+
+  return Rf_ScalarLogical(ok);
+}
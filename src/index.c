@@ -12,6 +12,10 @@
       R_CheckUserInterrupt();                                  \
     }                                                          \
                                                                \
+    if (p_incomplete != NULL && p_incomplete[i]) {             \
+      continue;                                                \
+    }                                                          \
+                                                               \
     increment_window(window, &index, range, i);                \
     slice_and_update_env(x, window.seq, env, type, container); \
                                                                \
@@ -63,7 +67,8 @@ SEXP slide_index_common_impl(SEXP x,
                              SEXP constrain_,
                              SEXP atomic_,
                              SEXP size_,
-                             SEXP complete_) {
+                             SEXP complete_,
+                             SEXP incomplete) {
   int n_prot = 0;
 
   const int type = r_scalar_int_get(type_);
@@ -73,6 +78,10 @@ SEXP slide_index_common_impl(SEXP x,
   const int size = r_scalar_int_get(size_);
   const bool complete = r_scalar_lgl_get(complete_);
 
+  // When sliding by group, the peer groups whose windows reach past the first
+  // or last value of their own group, which are skipped
+  const int* p_incomplete = (incomplete == R_NilValue) ? NULL : LOGICAL_RO(incomplete);
+
   struct index_info index = new_index_info(i);
   PROTECT_INDEX_INFO(&index, &n_prot);
 
@@ -432,6 +441,43 @@ int locate_peer_stops_pos(struct index_info* index, struct range_info range, int
 
 // -----------------------------------------------------------------------------
 
+// Number of elements of the ascending `p_x` that are smaller than `value`, or
+// smaller or equal to it when `inclusive`
+static int locate_bound(const int* p_x, int size, int value, bool inclusive) {
+  int lo = 0;
+  int hi = size;
+
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    const bool before = inclusive ? p_x[mid] <= value : p_x[mid] < value;
+
+    if (before) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+/*
+ * Moves the peer locators of `index` to where they would be after iterating
+ * up to `pos`, so iterations can start there. The starts and stops only
+ * ever move forwards, so the locators are found by binary search.
+ */
+// [[ include("index.h") ]]
+void index_info_seek(struct index_info* index, struct range_info range, int pos) {
+  if (!range.start_unbounded) {
+    index->current_start_pos = locate_bound(index->p_data, index->size, range.p_starts[pos], false);
+  }
+  if (!range.stop_unbounded) {
+    index->current_stop_pos = locate_bound(index->p_data, index->size, range.p_stops[pos], true);
+  }
+}
+
+// -----------------------------------------------------------------------------
+
 // [[ include("index.h") ]]
 void increment_window(struct window_info window,
                       struct index_info* index,
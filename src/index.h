@@ -68,6 +68,8 @@ struct window_info new_window_info(const int* p_peer_sizes,
 int locate_peer_starts_pos(struct index_info* index, struct range_info range, int pos);
 int locate_peer_stops_pos(struct index_info* index, struct range_info range, int pos);
 
+void index_info_seek(struct index_info* index, struct range_info range, int pos);
+
 void increment_window(struct window_info window,
                       struct index_info* index,
                       struct range_info range,
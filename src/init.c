@@ -2,31 +2,89 @@
 #include <Rinternals.h>
 #include <stdlib.h> // for NULL
 #include <R_ext/Rdynload.h>
+#include "../inst/include/slider.h"
 
 /* .Call calls */
 extern SEXP slide_common_impl(SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP hop_common_impl(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP slide_index_common_impl(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slide_index_common_impl(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP hop_index_common_impl(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_block(SEXP, SEXP, SEXP);
 extern SEXP slider_compute_from(SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_compute_to(SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_vec_set_names(SEXP, SEXP);
 extern SEXP slider_vec_names(SEXP);
-extern SEXP slider_sum(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP slider_mean(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP slider_prod(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP slider_min(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP slider_max(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP slider_all(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP slider_any(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_sum(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_mean(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_skew(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_kurt(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_prod(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_log_prod(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_geomean(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_min(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_max(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_max_drawdown(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_range(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_all(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_any(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_count_true(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_n(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_n_na(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_first(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_last(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_which_min(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_which_max(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_rank(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_n_distinct(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_mode(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_entropy(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_ewma(SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_filter(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_lm(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_mad(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_hampel(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_trimmed_mean(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_index_sum_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_index_mean_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_skew_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_kurt_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_index_prod_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_log_prod_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_geomean_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_index_min_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_index_max_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_max_drawdown_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_range_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_index_all_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP slider_index_any_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_count_true_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_n_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_n_na_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_first_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_last_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_which_min_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_which_max_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_rank_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_n_distinct_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_mode_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_entropy_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_lm_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_mad_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_hampel_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_trimmed_mean_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_ewma(SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_monoid(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_monoid_core(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_hop_monoid(SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_example_monoid();
+extern SEXP slider_compute_combined_ranks(SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_index_peers(SEXP, SEXP, SEXP);
+extern SEXP slider_check_generated_endpoints(SEXP, SEXP, SEXP);
+extern SEXP slider_offset_shift(SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_group_info(SEXP, SEXP, SEXP);
+extern SEXP slider_window_plan_encode(SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_window_plan_decode(SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP slider_get_query_counts(SEXP);
 
 // Defined below
 SEXP slider_initialize(SEXP);
@@ -34,35 +92,97 @@ SEXP slider_initialize(SEXP);
 static const R_CallMethodDef CallEntries[] = {
   {"slide_common_impl",         (DL_FUNC) &slide_common_impl, 5},
   {"hop_common_impl",           (DL_FUNC) &hop_common_impl, 7},
-  {"slide_index_common_impl",   (DL_FUNC) &slide_index_common_impl, 13},
+  {"slide_index_common_impl",   (DL_FUNC) &slide_index_common_impl, 14},
   {"hop_index_common_impl",     (DL_FUNC) &hop_index_common_impl, 12},
   {"slider_block",              (DL_FUNC) &slider_block, 3},
   {"slider_compute_from",       (DL_FUNC) &slider_compute_from, 4},
   {"slider_compute_to",         (DL_FUNC) &slider_compute_to, 4},
   {"slider_vec_set_names",      (DL_FUNC) &slider_vec_set_names, 2},
   {"slider_vec_names",          (DL_FUNC) &slider_vec_names, 1},
-  {"slider_sum",                (DL_FUNC) &slider_sum, 6},
-  {"slider_mean",               (DL_FUNC) &slider_mean, 6},
-  {"slider_prod",               (DL_FUNC) &slider_prod, 6},
-  {"slider_min",                (DL_FUNC) &slider_min, 6},
-  {"slider_max",                (DL_FUNC) &slider_max, 6},
-  {"slider_all",                (DL_FUNC) &slider_all, 6},
-  {"slider_any",                (DL_FUNC) &slider_any, 6},
+  {"slider_sum",                (DL_FUNC) &slider_sum, 7},
+  {"slider_mean",               (DL_FUNC) &slider_mean, 7},
+  {"slider_skew",               (DL_FUNC) &slider_skew, 7},
+  {"slider_kurt",               (DL_FUNC) &slider_kurt, 7},
+  {"slider_prod",               (DL_FUNC) &slider_prod, 7},
+  {"slider_log_prod",           (DL_FUNC) &slider_log_prod, 7},
+  {"slider_geomean",            (DL_FUNC) &slider_geomean, 7},
+  {"slider_min",                (DL_FUNC) &slider_min, 7},
+  {"slider_max",                (DL_FUNC) &slider_max, 7},
+  {"slider_max_drawdown",       (DL_FUNC) &slider_max_drawdown, 7},
+  {"slider_range",              (DL_FUNC) &slider_range, 7},
+  {"slider_all",                (DL_FUNC) &slider_all, 7},
+  {"slider_any",                (DL_FUNC) &slider_any, 7},
+  {"slider_count_true",         (DL_FUNC) &slider_count_true, 7},
+  {"slider_n",                  (DL_FUNC) &slider_n, 7},
+  {"slider_n_na",               (DL_FUNC) &slider_n_na, 6},
+  {"slider_first",              (DL_FUNC) &slider_first, 7},
+  {"slider_last",               (DL_FUNC) &slider_last, 7},
+  {"slider_which_min",          (DL_FUNC) &slider_which_min, 7},
+  {"slider_which_max",          (DL_FUNC) &slider_which_max, 7},
+  {"slider_rank",               (DL_FUNC) &slider_rank, 7},
+  {"slider_n_distinct",         (DL_FUNC) &slider_n_distinct, 7},
+  {"slider_mode",               (DL_FUNC) &slider_mode, 7},
+  {"slider_entropy",            (DL_FUNC) &slider_entropy, 7},
+  {"slider_ewma",               (DL_FUNC) &slider_ewma, 4},
+  {"slider_filter",             (DL_FUNC) &slider_filter, 8},
+  {"slider_lm",                 (DL_FUNC) &slider_lm, 8},
+  {"slider_mad",                (DL_FUNC) &slider_mad, 8},
+  {"slider_hampel",             (DL_FUNC) &slider_hampel, 8},
+  {"slider_trimmed_mean",       (DL_FUNC) &slider_trimmed_mean, 8},
   {"slider_index_sum_core",     (DL_FUNC) &slider_index_sum_core, 7},
   {"slider_index_mean_core",    (DL_FUNC) &slider_index_mean_core, 7},
+  {"slider_index_skew_core",    (DL_FUNC) &slider_index_skew_core, 7},
+  {"slider_index_kurt_core",    (DL_FUNC) &slider_index_kurt_core, 7},
   {"slider_index_prod_core",    (DL_FUNC) &slider_index_prod_core, 7},
+  {"slider_index_log_prod_core", (DL_FUNC) &slider_index_log_prod_core, 7},
+  {"slider_index_geomean_core", (DL_FUNC) &slider_index_geomean_core, 7},
   {"slider_index_min_core",     (DL_FUNC) &slider_index_min_core, 7},
   {"slider_index_max_core",     (DL_FUNC) &slider_index_max_core, 7},
+  {"slider_index_max_drawdown_core", (DL_FUNC) &slider_index_max_drawdown_core, 7},
+  {"slider_index_range_core",   (DL_FUNC) &slider_index_range_core, 7},
   {"slider_index_all_core",     (DL_FUNC) &slider_index_all_core, 7},
   {"slider_index_any_core",     (DL_FUNC) &slider_index_any_core, 7},
+  {"slider_index_count_true_core", (DL_FUNC) &slider_index_count_true_core, 7},
+  {"slider_index_n_core",       (DL_FUNC) &slider_index_n_core, 7},
+  {"slider_index_n_na_core",    (DL_FUNC) &slider_index_n_na_core, 7},
+  {"slider_index_first_core",   (DL_FUNC) &slider_index_first_core, 7},
+  {"slider_index_last_core",    (DL_FUNC) &slider_index_last_core, 7},
+  {"slider_index_which_min_core", (DL_FUNC) &slider_index_which_min_core, 7},
+  {"slider_index_which_max_core", (DL_FUNC) &slider_index_which_max_core, 7},
+  {"slider_index_rank_core",    (DL_FUNC) &slider_index_rank_core, 7},
+  {"slider_index_n_distinct_core", (DL_FUNC) &slider_index_n_distinct_core, 7},
+  {"slider_index_mode_core",    (DL_FUNC) &slider_index_mode_core, 7},
+  {"slider_index_entropy_core", (DL_FUNC) &slider_index_entropy_core, 7},
+  {"slider_index_lm_core",      (DL_FUNC) &slider_index_lm_core, 8},
+  {"slider_index_mad_core",     (DL_FUNC) &slider_index_mad_core, 8},
+  {"slider_index_hampel_core",  (DL_FUNC) &slider_index_hampel_core, 8},
+  {"slider_index_trimmed_mean_core", (DL_FUNC) &slider_index_trimmed_mean_core, 8},
+  {"slider_index_ewma",         (DL_FUNC) &slider_index_ewma, 5},
+  {"slider_monoid",             (DL_FUNC) &slider_monoid, 8},
+  {"slider_index_monoid_core",  (DL_FUNC) &slider_index_monoid_core, 8},
+  {"slider_hop_monoid",         (DL_FUNC) &slider_hop_monoid, 5},
+  {"slider_example_monoid",     (DL_FUNC) &slider_example_monoid, 0},
+  {"slider_compute_combined_ranks", (DL_FUNC) &slider_compute_combined_ranks, 4},
+  {"slider_index_peers",        (DL_FUNC) &slider_index_peers, 3},
+  {"slider_check_generated_endpoints", (DL_FUNC) &slider_check_generated_endpoints, 3},
+  {"slider_offset_shift",       (DL_FUNC) &slider_offset_shift, 5},
+  {"slider_group_info",         (DL_FUNC) &slider_group_info, 3},
+  {"slider_window_plan_encode", (DL_FUNC) &slider_window_plan_encode, 4},
+  {"slider_window_plan_decode", (DL_FUNC) &slider_window_plan_decode, 5},
+  {"slider_get_query_counts",   (DL_FUNC) &slider_get_query_counts, 1},
   {"slider_initialize",         (DL_FUNC) &slider_initialize, 1},
   {NULL, NULL, 0}
 };
 
+/* C callables, see `inst/include/slider.h` */
+extern SEXP exp_new_monoid(const struct slider_monoid*);
+
 void R_init_slider(DllInfo *dll)
 {
   R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
   R_useDynamicSymbols(dll, FALSE);
+
+  R_RegisterCCallable("slider", "exp_new_monoid", (DL_FUNC) &exp_new_monoid);
 }
 
 // slider-vctrs-private.c
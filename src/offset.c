@@ -0,0 +1,261 @@
+#include "slider.h"
+#include "utils.h"
+
+/*
+ * Calendar offsets of Date and POSIXct vectors, computed on their underlying
+ * day and second counts. POSIXct input is shifted on its local clock, which
+ * the R side supplies as seconds since the epoch in UTC.
+ *
+ * Months, quarters, and years are shifted on the civil calendar, clamping to
+ * the end of the month when the day doesn't exist in the target month. The
+ * conversions between day counts and civil dates are Howard Hinnant's
+ * `days_from_civil()` and `civil_from_days()` algorithms.
+ */
+
+#define SECONDS_PER_DAY 86400
+
+enum offset_period {
+  OFFSET_DAY,
+  OFFSET_WEEK,
+  OFFSET_MONTH,
+  OFFSET_YEAR,
+  OFFSET_BUSINESS_DAY
+};
+
+static enum offset_period as_offset_period(SEXP period) {
+  const char* c_period = r_scalar_chr_get(period);
+
+  if (!strcmp(c_period, "day")) return OFFSET_DAY;
+  if (!strcmp(c_period, "week")) return OFFSET_WEEK;
+  if (!strcmp(c_period, "month")) return OFFSET_MONTH;
+  if (!strcmp(c_period, "year")) return OFFSET_YEAR;
+  if (!strcmp(c_period, "business_day")) return OFFSET_BUSINESS_DAY;
+
+  Rf_errorcall(R_NilValue, "Internal error: Unknown offset period `%s`.", c_period);
+}
+
+static inline int64_t floor_div(int64_t x, int64_t y) {
+  const int64_t quotient = x / y;
+  return (x % y != 0 && ((x < 0) != (y < 0))) ? quotient - 1 : quotient;
+}
+
+// -----------------------------------------------------------------------------
+
+struct civil {
+  int64_t year;
+  int month;
+  int day;
+};
+
+static inline struct civil civil_from_days(int64_t days) {
+  days += 719468;
+
+  const int64_t era = floor_div(days, 146097);
+  const int64_t doe = days - era * 146097;
+  const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int64_t mp = (5 * doy + 2) / 153;
+
+  const int day = (int) (doy - (153 * mp + 2) / 5 + 1);
+  const int month = (int) (mp < 10 ? mp + 3 : mp - 9);
+  const int64_t year = yoe + era * 400 + (month <= 2);
+
+  return (struct civil) { .year = year, .month = month, .day = day };
+}
+
+static inline int64_t days_from_civil(struct civil date) {
+  const int64_t year = date.year - (date.month <= 2);
+  const int64_t era = floor_div(year, 400);
+  const int64_t yoe = year - era * 400;
+  const int64_t mp = date.month > 2 ? date.month - 3 : date.month + 9;
+  const int64_t doy = (153 * mp + 2) / 5 + date.day - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+  return era * 146097 + doe - 719468;
+}
+
+static inline bool is_leap_year(int64_t year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static inline int days_in_month(int64_t year, int month) {
+  static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return (month == 2 && is_leap_year(year)) ? 29 : days[month - 1];
+}
+
+static inline int64_t shift_months(int64_t days, int64_t n) {
+  struct civil date = civil_from_days(days);
+
+  const int64_t months = date.year * 12 + (date.month - 1) + n;
+
+  date.year = floor_div(months, 12);
+  date.month = (int) (months - date.year * 12) + 1;
+  date.day = min(date.day, days_in_month(date.year, date.month));
+
+  return days_from_civil(date);
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Business days are Monday to Friday, minus the `holidays`, which are sorted
+ * unique weekdays. They are counted with ordinals: the ordinal of a day is
+ * the number of business days strictly before it, starting from the Monday
+ * 1969-12-29. The weekday ordinal is the same, ignoring holidays.
+ */
+
+struct business_calendar {
+  const double* p_holidays;
+  R_xlen_t n_holidays;
+};
+
+// 1970-01-01 is a Thursday, 3 days after a Monday
+static inline int64_t weekday_ordinal(int64_t days, bool* p_is_weekday) {
+  const int64_t since_monday = days + 3;
+  const int64_t weeks = floor_div(since_monday, 7);
+  const int64_t weekday = since_monday - weeks * 7;
+
+  *p_is_weekday = weekday < 5;
+  return weeks * 5 + (weekday < 5 ? weekday : 5);
+}
+
+static inline int64_t days_from_weekday_ordinal(int64_t ordinal) {
+  const int64_t weeks = floor_div(ordinal, 5);
+  return weeks * 7 + (ordinal - weeks * 5) - 3;
+}
+
+// Number of holidays strictly before `days`
+static inline R_xlen_t holidays_before(const struct business_calendar* p_calendar, int64_t days) {
+  R_xlen_t lo = 0;
+  R_xlen_t hi = p_calendar->n_holidays;
+
+  while (lo < hi) {
+    const R_xlen_t mid = lo + (hi - lo) / 2;
+
+    if (p_calendar->p_holidays[mid] < days) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+// The business day with `ordinal`. Holiday `j` has a business day ordinal of
+// its weekday ordinal minus `j`, so the holidays before the target are the
+// ones for which that is at most `ordinal`.
+static inline int64_t days_from_business_ordinal(const struct business_calendar* p_calendar,
+                                                 int64_t ordinal) {
+  R_xlen_t lo = 0;
+  R_xlen_t hi = p_calendar->n_holidays;
+
+  while (lo < hi) {
+    const R_xlen_t mid = lo + (hi - lo) / 2;
+
+    bool is_weekday;
+    const int64_t holiday = (int64_t) p_calendar->p_holidays[mid];
+    const int64_t holiday_ordinal = weekday_ordinal(holiday, &is_weekday) - mid;
+
+    if (holiday_ordinal <= ordinal) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return days_from_weekday_ordinal(ordinal + lo);
+}
+
+/*
+ * Shifts `days` by `n` business days. A day that isn't a business day first
+ * rolls to the next business day when shifting backwards, and to the previous
+ * one when shifting forwards, so that one business day before or after a
+ * Saturday is the Friday before it or the Monday after it.
+ */
+static inline int64_t shift_business_days(const struct business_calendar* p_calendar,
+                                          int64_t days,
+                                          int64_t n) {
+  if (n == 0) {
+    return days;
+  }
+
+  bool is_weekday;
+  const R_xlen_t n_before = holidays_before(p_calendar, days);
+  const bool is_holiday = n_before < p_calendar->n_holidays && p_calendar->p_holidays[n_before] == days;
+
+  // Business days strictly before `days`
+  int64_t ordinal = weekday_ordinal(days, &is_weekday) - n_before;
+
+  // Rolling forwards is free, as the next business day shares the ordinal
+  if (n > 0 && (!is_weekday || is_holiday)) {
+    --ordinal;
+  }
+
+  return days_from_business_ordinal(p_calendar, ordinal + n);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline int64_t shift_days(enum offset_period period,
+                                 const struct business_calendar* p_calendar,
+                                 int64_t days,
+                                 int64_t n) {
+  switch (period) {
+  case OFFSET_DAY: return days + n;
+  case OFFSET_WEEK: return days + 7 * n;
+  case OFFSET_MONTH: return shift_months(days, n);
+  case OFFSET_YEAR: return shift_months(days, 12 * n);
+  case OFFSET_BUSINESS_DAY: return shift_business_days(p_calendar, days, n);
+  }
+
+  never_reached("shift_days");
+}
+
+/*
+ * Shifts `x`, a double vector of days, or of seconds when `seconds` is `true`,
+ * by `n` periods. Seconds keep their time of day. Infinite values are kept.
+ */
+// [[ register() ]]
+SEXP slider_offset_shift(SEXP x, SEXP n, SEXP period, SEXP holidays, SEXP seconds) {
+  const double* p_x = REAL_RO(x);
+  const R_xlen_t size = Rf_xlength(x);
+
+  const int64_t c_n = (int64_t) r_scalar_int_get(n);
+  const enum offset_period c_period = as_offset_period(period);
+  const bool c_seconds = r_scalar_lgl_get(seconds);
+
+  const struct business_calendar calendar = {
+    .p_holidays = REAL_RO(holidays),
+    .n_holidays = Rf_xlength(holidays)
+  };
+
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, size));
+  double* p_out = REAL(out);
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    const double elt = p_x[i];
+
+    if (!isfinite(elt)) {
+      p_out[i] = elt;
+      continue;
+    }
+
+    if (c_seconds) {
+      const double days = floor(elt / SECONDS_PER_DAY);
+      const double time = elt - days * SECONDS_PER_DAY;
+      const int64_t shifted = shift_days(c_period, &calendar, (int64_t) days, c_n);
+      p_out[i] = (double) shifted * SECONDS_PER_DAY + time;
+    } else {
+      const double days = floor(elt);
+      const double time = elt - days;
+      const int64_t shifted = shift_days(c_period, &calendar, (int64_t) days, c_n);
+      p_out[i] = (double) shifted + time;
+    }
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+#undef SECONDS_PER_DAY
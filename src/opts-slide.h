@@ -3,6 +3,7 @@
 
 #include "slider.h"
 #include "params.h"
+#include "group.h"
 
 // -----------------------------------------------------------------------------
 
@@ -17,6 +18,9 @@ struct slide_opts {
 
   int step;
   bool complete;
+
+  // Only set by the summary functions when sliding by group, `NULL` otherwise
+  const struct group_info* p_groups;
 };
 
 static inline struct slide_opts new_slide_opts(SEXP before, SEXP after, SEXP step, SEXP complete, bool dot) {
@@ -44,7 +48,8 @@ static inline struct slide_opts new_slide_opts(SEXP before, SEXP after, SEXP ste
     .after_unbounded = c_after_unbounded,
     .after_positive = c_after_positive,
     .step = c_step,
-    .complete = c_complete
+    .complete = c_complete,
+    .p_groups = NULL
   };
 }
 
@@ -62,6 +67,9 @@ struct iter_opts {
   R_xlen_t stop_step;
 
   R_xlen_t size;
+
+  // To start over at each group when sliding by group
+  struct slide_opts opts;
 };
 
 static inline struct iter_opts new_iter_opts(struct slide_opts opts, R_xlen_t size) {
@@ -113,9 +121,78 @@ static inline struct iter_opts new_iter_opts(struct slide_opts opts, R_xlen_t si
     .start_step = start_step,
     .stop = stop,
     .stop_step = stop_step,
-    .size = size
+    .size = size,
+    .opts = opts
   };
 }
 
+// -----------------------------------------------------------------------------
+
+static inline R_xlen_t iter_opts_n_groups(const struct iter_opts* p_opts) {
+  const struct group_info* p_groups = p_opts->opts.p_groups;
+  return (p_groups == NULL) ? 1 : p_groups->n;
+}
+
+// The iterations over the rows of `group` when sliding by group, or over all
+// of the rows otherwise
+static inline struct iter_opts iter_opts_group(const struct iter_opts* p_opts, R_xlen_t group) {
+  const struct group_info* p_groups = p_opts->opts.p_groups;
+
+  if (p_groups == NULL) {
+    return *p_opts;
+  }
+
+  return new_iter_opts(p_opts->opts, p_groups->p_sizes[group]);
+}
+
+// The position of the first row of each group, followed by the number of rows
+static inline R_xlen_t* iter_opts_group_starts(const struct iter_opts* p_opts) {
+  const R_xlen_t n_groups = iter_opts_n_groups(p_opts);
+  R_xlen_t* p_starts = (R_xlen_t*) R_alloc(n_groups + 1, sizeof(R_xlen_t));
+
+  p_starts[0] = 0;
+
+  for (R_xlen_t group = 0; group < n_groups; ++group) {
+    p_starts[group + 1] = p_starts[group] + iter_opts_group(p_opts, group).size;
+  }
+
+  return p_starts;
+}
+
+// Binary search for the group holding the row at `position`, with the
+// `p_starts` of `iter_opts_group_starts()`
+static inline R_xlen_t iter_opts_find_group(const R_xlen_t* p_starts,
+                                            R_xlen_t n_groups,
+                                            R_xlen_t position) {
+  R_xlen_t lo = 0;
+  R_xlen_t hi = n_groups - 1;
+
+  while (lo < hi) {
+    const R_xlen_t mid = lo + (hi - lo + 1) / 2;
+
+    if (p_starts[mid] <= position) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  return lo;
+}
+
+// Maps the 1-based locations of `p_locs`, which are positions in the rows as
+// they are iterated over, back to positions in the original rows
+static inline void iter_opts_locate(const struct iter_opts* p_opts, int* p_locs, R_xlen_t size) {
+  const struct group_info* p_groups = p_opts->opts.p_groups;
+
+  if (p_groups == NULL) {
+    return;
+  }
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    p_locs[i] = group_info_location(p_groups, p_locs[i]);
+  }
+}
+
 // -----------------------------------------------------------------------------
 #endif
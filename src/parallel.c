@@ -0,0 +1,148 @@
+#include "parallel.h"
+#include "utils.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// -----------------------------------------------------------------------------
+
+/*
+ * The number of threads to run a loop of `size` iterations on, from the
+ * `slider.threads` option. Loops run on the main thread alone by default,
+ * when they are too small to be worth it, or when the package was built
+ * without OpenMP.
+ */
+// [[ include("parallel.h") ]]
+int parallel_n_threads(R_xlen_t size) {
+  SEXP option = Rf_GetOption1(Rf_install("slider.threads"));
+
+  if (option == R_NilValue) {
+    return 1;
+  }
+
+  const int n_threads = Rf_asInteger(option);
+
+  if (n_threads == NA_INTEGER || n_threads < 1) {
+    Rf_errorcall(R_NilValue, "The `slider.threads` option must be a positive whole number.");
+  }
+
+#ifdef _OPENMP
+  if (size < PARALLEL_MIN_SIZE) {
+    return 1;
+  }
+
+  return min(n_threads, omp_get_num_procs());
+#else
+  return 1;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+
+#ifdef _OPENMP
+
+/*
+ * The chunks `[next, end)` that are left in the queue of a thread. Both the
+ * thread and the ones stealing from it take chunks from the front, with an
+ * atomic increment of `next`, so each chunk is run exactly once. Queues are
+ * padded so threads don't share cache lines.
+ */
+struct parallel_queue {
+  R_xlen_t next;
+  R_xlen_t end;
+  char padding[64 - 2 * sizeof(R_xlen_t)];
+};
+
+// Returns a chunk of the queue, which is past its end when it is empty
+static inline R_xlen_t parallel_queue_pop(struct parallel_queue* p_queue) {
+  R_xlen_t chunk;
+
+  #pragma omp atomic capture
+  chunk = p_queue->next++;
+
+  return chunk;
+}
+
+static inline R_xlen_t parallel_queue_n_left(struct parallel_queue* p_queue) {
+  R_xlen_t next;
+
+  #pragma omp atomic read
+  next = p_queue->next;
+
+  return p_queue->end - next;
+}
+
+// The queue with the most chunks left, or `-1` when all of them are empty
+static int parallel_find_victim(struct parallel_queue* p_queues, int n_threads) {
+  int victim = -1;
+  R_xlen_t victim_n_left = 0;
+
+  for (int thread = 0; thread < n_threads; ++thread) {
+    const R_xlen_t n_left = parallel_queue_n_left(&p_queues[thread]);
+
+    if (n_left > victim_n_left) {
+      victim = thread;
+      victim_n_left = n_left;
+    }
+  }
+
+  return victim;
+}
+
+#endif
+
+/*
+ * Runs `fn` over the `size` iterations of a loop, on `n_threads` threads.
+ *
+ * The iterations are split in chunks, and each thread starts with a queue of
+ * a contiguous block of them. Threads that run out of chunks steal them from
+ * the queue with the most chunks left, so a thread that is slowed down by
+ * expensive iterations doesn't hold up the others. Which thread runs a chunk
+ * changes from one run to the next, but `fn` writes the results of each
+ * iteration to their own place, so the output doesn't.
+ */
+// [[ include("parallel.h") ]]
+void parallel_for(R_xlen_t size, int n_threads, parallel_chunk_fn fn, void* p_data) {
+#ifdef _OPENMP
+  if (n_threads > 1 && size > 0) {
+    R_xlen_t chunk_size = size / ((R_xlen_t) n_threads * PARALLEL_CHUNKS_PER_THREAD);
+    chunk_size = max_size(chunk_size, PARALLEL_MIN_CHUNK_SIZE);
+
+    const R_xlen_t n_chunks = (size + chunk_size - 1) / chunk_size;
+
+    struct parallel_queue* p_queues = (struct parallel_queue*) R_alloc(n_threads, sizeof(struct parallel_queue));
+
+    for (int thread = 0; thread < n_threads; ++thread) {
+      p_queues[thread].next = n_chunks * thread / n_threads;
+      p_queues[thread].end = n_chunks * (thread + 1) / n_threads;
+    }
+
+    // Queues of threads that OpenMP doesn't start are stolen from entirely
+    #pragma omp parallel num_threads(n_threads)
+    {
+      const int thread = omp_get_thread_num();
+      int victim = thread;
+
+      while (victim >= 0) {
+        struct parallel_queue* p_queue = &p_queues[victim];
+        const R_xlen_t chunk = parallel_queue_pop(p_queue);
+
+        if (chunk >= p_queue->end) {
+          victim = parallel_find_victim(p_queues, n_threads);
+          continue;
+        }
+
+        const R_xlen_t begin = chunk * chunk_size;
+        const R_xlen_t end = min_size(begin + chunk_size, size);
+
+        fn(p_data, thread, begin, end);
+      }
+    }
+
+    return;
+  }
+#endif
+
+  fn(p_data, 0, 0, size);
+}
@@ -0,0 +1,32 @@
+#ifndef SLIDER_PARALLEL_H
+#define SLIDER_PARALLEL_H
+
+#include "slider.h"
+
+// -----------------------------------------------------------------------------
+
+// Fewest iterations that are worth spreading over threads, and fewest
+// iterations of a chunk
+#define PARALLEL_MIN_SIZE 16384
+#define PARALLEL_MIN_CHUNK_SIZE 1024
+
+// Chunks per thread, so there is always something left to steal when threads
+// finish their own chunks at different times
+#define PARALLEL_CHUNKS_PER_THREAD 16
+
+/*
+ * Runs `fn` over iterations `[begin, end)` of a loop of `size` iterations,
+ * split in chunks. `thread` identifies the calling thread, between `0` and
+ * `n_threads - 1`, for any scratch space that `fn` needs per thread.
+ *
+ * `fn` is called from threads other than the main one, so it must not use
+ * the R API, including `R_CheckUserInterrupt()` and memory allocation.
+ */
+typedef void (*parallel_chunk_fn)(void* p_data, int thread, R_xlen_t begin, R_xlen_t end);
+
+int parallel_n_threads(R_xlen_t size);
+
+void parallel_for(R_xlen_t size, int n_threads, parallel_chunk_fn fn, void* p_data);
+
+// -----------------------------------------------------------------------------
+#endif
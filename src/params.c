@@ -34,6 +34,10 @@ static SEXP check_lgl(SEXP x) {
   return check_ptype(x, slider_shared_empty_lgl);
 }
 
+static SEXP check_dbl(SEXP x) {
+  return check_ptype(x, slider_shared_empty_dbl);
+}
+
 static SEXP check_scalar_int(SEXP x, SEXP x_arg) {
   check_scalar(x, x_arg);
   return check_int(x);
@@ -44,6 +48,11 @@ static SEXP check_scalar_lgl(SEXP x, SEXP x_arg) {
   return check_lgl(x);
 }
 
+static SEXP check_scalar_dbl(SEXP x, SEXP x_arg) {
+  check_scalar(x, x_arg);
+  return check_dbl(x);
+}
+
 // -----------------------------------------------------------------------------
 
 static bool is_unbounded(SEXP x) {
@@ -175,6 +184,92 @@ int validate_na_rm(SEXP x, bool dot) {
   return out;
 }
 
+// [[ include("params.h") ]]
+double validate_half_life(SEXP x) {
+  x = PROTECT(check_scalar_dbl(x, strings_half_life));
+  double out = REAL(x)[0];
+
+  if (ISNAN(out)) {
+    Rf_errorcall(R_NilValue, "`half_life` can't be missing.");
+  }
+
+  if (out <= 0 || out == R_PosInf) {
+    Rf_errorcall(R_NilValue, "`half_life` must be a positive finite number, not %g.", out);
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+static double validate_non_negative(SEXP x, SEXP x_arg) {
+  x = PROTECT(check_scalar_dbl(x, x_arg));
+  double out = REAL(x)[0];
+
+  const char* arg = r_scalar_chr_get(x_arg);
+
+  if (ISNAN(out)) {
+    Rf_errorcall(R_NilValue, "`%s` can't be missing.", arg);
+  }
+
+  if (out < 0 || out == R_PosInf) {
+    Rf_errorcall(R_NilValue, "`%s` must be a non-negative finite number, not %g.", arg, out);
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ include("params.h") ]]
+double validate_constant(SEXP x) {
+  return validate_non_negative(x, strings_constant);
+}
+
+// [[ include("params.h") ]]
+double validate_k(SEXP x) {
+  return validate_non_negative(x, strings_k);
+}
+
+// [[ include("params.h") ]]
+double validate_trim(SEXP x) {
+  x = PROTECT(check_scalar_dbl(x, strings_trim));
+  double out = REAL(x)[0];
+
+  if (ISNAN(out)) {
+    Rf_errorcall(R_NilValue, "`trim` can't be missing.");
+  }
+
+  if (out < 0 || out > 0.5) {
+    Rf_errorcall(R_NilValue, "`trim` must be a number between 0 and 0.5, not %g.", out);
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ include("params.h") ]]
+SEXP validate_weights(SEXP x) {
+  x = PROTECT(check_dbl(x));
+
+  const R_xlen_t size = Rf_xlength(x);
+  const double* p_x = REAL_RO(x);
+
+  if (size == 0) {
+    Rf_errorcall(R_NilValue, "`weights` must have at least one element.");
+  }
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    if (ISNAN(p_x[i])) {
+      Rf_errorcall(R_NilValue, "`weights` can't have missing values.");
+    }
+    if (!R_FINITE(p_x[i])) {
+      Rf_errorcall(R_NilValue, "`weights` must be finite.");
+    }
+  }
+
+  UNPROTECT(1);
+  return x;
+}
+
 // -----------------------------------------------------------------------------
 
 // [[ include("params.h") ]]
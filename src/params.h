@@ -11,6 +11,11 @@ int validate_after(SEXP x, bool* after_unbounded, bool dot);
 int validate_step(SEXP x, bool dot);
 int validate_complete(SEXP x, bool dot);
 int validate_na_rm(SEXP x, bool dot);
+double validate_half_life(SEXP x);
+double validate_constant(SEXP x);
+double validate_k(SEXP x);
+double validate_trim(SEXP x);
+SEXP validate_weights(SEXP x);
 
 void check_double_negativeness(int before, int after, bool before_positive, bool after_positive);
 void check_after_negativeness(int after, int before, bool after_positive, bool before_unbounded);
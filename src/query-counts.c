@@ -0,0 +1,35 @@
+#include "slider.h"
+#include "query-counts.h"
+#include "utils.h"
+
+// -----------------------------------------------------------------------------
+
+static struct query_counts total = { .n_queries = 0, .n_reused = 0 };
+
+// [[ include("query-counts.h") ]]
+void query_counts_record(struct query_counts counts) {
+  total.n_queries += counts.n_queries;
+  total.n_reused += counts.n_reused;
+}
+
+// Doubles, as the totals can grow past the range of an integer
+// [[ register() ]]
+SEXP slider_get_query_counts(SEXP reset) {
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, 2));
+  double* p_out = REAL(out);
+
+  p_out[0] = (double) total.n_queries;
+  p_out[1] = (double) total.n_reused;
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 2));
+  SET_STRING_ELT(names, 0, Rf_mkChar("queries"));
+  SET_STRING_ELT(names, 1, Rf_mkChar("reused"));
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  if (r_scalar_lgl_get(reset)) {
+    total = new_query_counts();
+  }
+
+  UNPROTECT(2);
+  return out;
+}
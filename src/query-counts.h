@@ -0,0 +1,32 @@
+#ifndef SLIDER_QUERY_COUNTS_H
+#define SLIDER_QUERY_COUNTS_H
+
+#include "slider.h"
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Bursty or sparse indices often give runs of peer groups with the exact
+ * same window, like the values of a burst that all see the whole burst.
+ * Index and hop summaries only compute the first window of a run, and reuse
+ * its result for the rest of it.
+ *
+ * `n_queries` counts the windows that were summarized, and `n_reused` the
+ * ones of them that reused the result of the window before. Loops count into
+ * their own `struct query_counts`, which is added to the session totals
+ * returned by `slider_query_counts()` with `query_counts_record()`, from the
+ * main thread.
+ */
+struct query_counts {
+  R_xlen_t n_queries;
+  R_xlen_t n_reused;
+};
+
+static inline struct query_counts new_query_counts(void) {
+  return (struct query_counts) { .n_queries = 0, .n_reused = 0 };
+}
+
+void query_counts_record(struct query_counts counts);
+
+// -----------------------------------------------------------------------------
+#endif
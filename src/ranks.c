@@ -0,0 +1,126 @@
+#include "slider.h"
+#include "group.h"
+#include "utils.h"
+
+/*
+ * Dense ranks of the combination of `i`, `starts`, and `stops`, as expected
+ * by `new_index_info()` and `new_range_info()`.
+ *
+ * All three are compare proxies of the same type that have already been
+ * checked to be ascending and free of missing values, so the ranks come from
+ * a single merge rather than a sort. At each step, the smallest of the
+ * current heads gets the next rank, along with every head that is equal to
+ * it, and those heads are advanced. `starts` and `stops` may be `NULL` when
+ * they are unbounded.
+ *
+ * When sliding by group, `i` and the endpoints generated from it are split
+ * into the same contiguous groups of `group_sizes`, and each group is merged
+ * on its own. The ranks keep increasing from one group to the next, so
+ * windows never span two groups.
+ */
+
+// Where the group that starts at `loc` stops. Unbounded endpoints are empty.
+static inline R_xlen_t group_stop(const struct group_info* p_groups,
+                                  R_xlen_t group,
+                                  R_xlen_t loc,
+                                  R_xlen_t size) {
+  return size == 0 ? 0 : loc + group_info_size(p_groups, group, size);
+}
+
+#define COMBINED_RANKS_MERGE(CTYPE, CONST_DEREF) do {                                 \
+  const CTYPE* p_i = CONST_DEREF(i);                                                  \
+  const CTYPE* p_starts = start_unbounded ? NULL : CONST_DEREF(starts);               \
+  const CTYPE* p_stops = stop_unbounded ? NULL : CONST_DEREF(stops);                  \
+                                                                                      \
+  R_xlen_t loc_i = 0;                                                                 \
+  R_xlen_t loc_starts = 0;                                                            \
+  R_xlen_t loc_stops = 0;                                                             \
+                                                                                      \
+  int rank = 0;                                                                       \
+                                                                                      \
+  for (R_xlen_t group = 0; group < groups.n; ++group) {                               \
+    const R_xlen_t i_stop = group_stop(&groups, group, loc_i, i_size);                \
+    const R_xlen_t starts_stop = group_stop(&groups, group, loc_starts, starts_size); \
+    const R_xlen_t stops_stop = group_stop(&groups, group, loc_stops, stops_size);    \
+                                                                                      \
+    while (loc_i < i_stop || loc_starts < starts_stop || loc_stops < stops_stop) {    \
+      bool has_value = false;                                                         \
+      CTYPE value = 0;                                                                \
+                                                                                      \
+      if (loc_i < i_stop) {                                                           \
+        value = p_i[loc_i];                                                           \
+        has_value = true;                                                             \
+      }                                                                               \
+      if (loc_starts < starts_stop && (!has_value || p_starts[loc_starts] < value)) { \
+        value = p_starts[loc_starts];                                                 \
+        has_value = true;                                                             \
+      }                                                                               \
+      if (loc_stops < stops_stop && (!has_value || p_stops[loc_stops] < value)) {     \
+        value = p_stops[loc_stops];                                                   \
+      }                                                                               \
+                                                                                      \
+      ++rank;                                                                         \
+                                                                                      \
+      while (loc_i < i_stop && p_i[loc_i] == value) {                                 \
+        p_out_i[loc_i++] = rank;                                                      \
+      }                                                                               \
+      while (loc_starts < starts_stop && p_starts[loc_starts] == value) {             \
+        p_out_starts[loc_starts++] = rank;                                            \
+      }                                                                               \
+      while (loc_stops < stops_stop && p_stops[loc_stops] == value) {                 \
+        p_out_stops[loc_stops++] = rank;                                              \
+      }                                                                               \
+    }                                                                                 \
+  }                                                                                   \
+} while (0)
+
+// [[ register() ]]
+SEXP slider_compute_combined_ranks(SEXP i, SEXP starts, SEXP stops, SEXP group_sizes) {
+  int n_prot = 0;
+
+  const struct group_info groups = new_group_info(group_sizes, R_NilValue);
+
+  const bool start_unbounded = (starts == R_NilValue);
+  const bool stop_unbounded = (stops == R_NilValue);
+
+  const R_xlen_t i_size = Rf_xlength(i);
+  const R_xlen_t starts_size = start_unbounded ? 0 : Rf_xlength(starts);
+  const R_xlen_t stops_size = stop_unbounded ? 0 : Rf_xlength(stops);
+
+  SEXP out_i = PROTECT_N(Rf_allocVector(INTSXP, i_size), &n_prot);
+  SEXP out_starts = start_unbounded ? R_NilValue : PROTECT_N(Rf_allocVector(INTSXP, starts_size), &n_prot);
+  SEXP out_stops = stop_unbounded ? R_NilValue : PROTECT_N(Rf_allocVector(INTSXP, stops_size), &n_prot);
+
+  int* p_out_i = INTEGER(out_i);
+  int* p_out_starts = start_unbounded ? NULL : INTEGER(out_starts);
+  int* p_out_stops = stop_unbounded ? NULL : INTEGER(out_stops);
+
+  // `starts` and `stops` are read with the type of `i`
+  if ((!start_unbounded && TYPEOF(starts) != TYPEOF(i)) ||
+      (!stop_unbounded && TYPEOF(stops) != TYPEOF(i))) {
+    Rf_errorcall(R_NilValue, "Internal error: `starts` and `stops` must have the same type as `i`.");
+  }
+
+  switch (TYPEOF(i)) {
+  case LGLSXP: COMBINED_RANKS_MERGE(int, LOGICAL_RO); break;
+  case INTSXP: COMBINED_RANKS_MERGE(int, INTEGER_RO); break;
+  case REALSXP: COMBINED_RANKS_MERGE(double, REAL_RO); break;
+  default: never_reached("slider_compute_combined_ranks");
+  }
+
+  SEXP out = PROTECT_N(Rf_allocVector(VECSXP, 3), &n_prot);
+  SET_VECTOR_ELT(out, 0, out_i);
+  SET_VECTOR_ELT(out, 1, out_starts);
+  SET_VECTOR_ELT(out, 2, out_stops);
+
+  SEXP names = PROTECT_N(Rf_allocVector(STRSXP, 3), &n_prot);
+  SET_STRING_ELT(names, 0, Rf_mkChar("i"));
+  SET_STRING_ELT(names, 1, Rf_mkChar("starts"));
+  SET_STRING_ELT(names, 2, Rf_mkChar("stops"));
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+#undef COMBINED_RANKS_MERGE
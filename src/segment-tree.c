@@ -2,10 +2,17 @@
 #include "utils.h"
 
 static void segment_tree_initialize_levels(struct segment_tree* p_tree);
+static void segment_tree_count_nodes(struct segment_tree* p_tree);
+static void segment_tree_aggregate_runs(SEXP leaves,
+                                        uint64_t n_leaves,
+                                        const int* p_run_sizes,
+                                        void* p_runs,
+                                        void* (*nodes_increment)(void* p_nodes),
+                                        void (*aggregate_from_leaves)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest));
 
 // [[ include("segment-tree.h") ]]
 struct segment_tree new_segment_tree(uint64_t n_leaves,
-                                     const void* p_leaves,
+                                     SEXP leaves,
                                      void* p_state,
                                      void (*state_reset)(void* p_state),
                                      void (*state_finalize)(void* p_state, void* p_result),
@@ -17,17 +24,24 @@ struct segment_tree new_segment_tree(uint64_t n_leaves,
   struct segment_tree tree;
 
   tree.n_leaves = n_leaves;
-  tree.n_levels = 0;
-  tree.n_nodes = 0;
-
-  uint64_t n_level_nodes = n_leaves;
-  while (n_level_nodes > 1) {
-    n_level_nodes = (uint64_t) ceil((double) n_level_nodes / SEGMENT_TREE_FANOUT);
-    tree.n_nodes += n_level_nodes;
-    ++tree.n_levels;
+  tree.runs = false;
+  segment_tree_count_nodes(&tree);
+
+  tree.leaves = leaves;
+  tree.p_leaves = r_vec_deref_or_null(leaves);
+  tree.leaf_size = r_vec_elt_size(leaves);
+
+  // ALTREP leaves without a data pointer are pulled in chunks through a
+  // buffer, rather than being materialized in full
+  if (tree.p_leaves == NULL) {
+    tree.leaves_buffer = Rf_allocVector(RAWSXP, SEGMENT_TREE_LEAVES_CHUNK_SIZE * tree.leaf_size);
+    tree.p_leaves_buffer = (void*) RAW(tree.leaves_buffer);
+  } else {
+    tree.leaves_buffer = R_NilValue;
+    tree.p_leaves_buffer = NULL;
   }
+  PROTECT(tree.leaves_buffer);
 
-  tree.p_leaves = p_leaves;
   tree.p_state = p_state;
 
   tree.p_level = PROTECT(Rf_allocVector(RAWSXP, tree.n_levels * sizeof(void*)));
@@ -44,10 +58,189 @@ struct segment_tree new_segment_tree(uint64_t n_leaves,
 
   segment_tree_initialize_levels(&tree);
 
-  UNPROTECT(2);
+  UNPROTECT(3);
   return tree;
 }
 
+/*
+ * Like `new_segment_tree()`, but when the `n_runs` runs of `p_run_sizes`
+ * are long enough on average, each run of leaves is first aggregated into a
+ * node of its own, and the tree is built over these nodes instead. The tree
+ * is then smaller and shallower by the mean size of a run, and `runs` is set
+ * to signal that it is queried by runs rather than by leaves.
+ *
+ * Runs are aggregated in a single pass over the leaves, so ALTREP leaves are
+ * only pulled once, and the tree never goes through the leaves buffer.
+ */
+// [[ include("segment-tree.h") ]]
+struct segment_tree new_segment_tree_runs(uint64_t n_leaves,
+                                          SEXP leaves,
+                                          uint64_t n_runs,
+                                          const int* p_run_sizes,
+                                          void* p_state,
+                                          void (*state_reset)(void* p_state),
+                                          void (*state_finalize)(void* p_state, void* p_result),
+                                          void* (*nodes_increment)(void* p_nodes),
+                                          SEXP (*nodes_initialize)(uint64_t n),
+                                          void* (*nodes_void_deref)(SEXP nodes),
+                                          void (*aggregate_from_leaves)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest),
+                                          void (*aggregate_from_nodes)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest)) {
+  if (n_runs == 0 || n_leaves < SEGMENT_TREE_RUNS_MIN_MEAN_SIZE * n_runs) {
+    return new_segment_tree(
+      n_leaves,
+      leaves,
+      p_state,
+      state_reset,
+      state_finalize,
+      nodes_increment,
+      nodes_initialize,
+      nodes_void_deref,
+      aggregate_from_leaves,
+      aggregate_from_nodes
+    );
+  }
+
+  struct segment_tree tree;
+
+  tree.n_leaves = n_runs;
+  tree.runs = true;
+  segment_tree_count_nodes(&tree);
+
+  // The nodes of the runs come first, followed by the nodes of the tree
+  tree.nodes = PROTECT(nodes_initialize(n_runs + tree.n_nodes));
+  void* p_runs = nodes_void_deref(tree.nodes);
+
+  segment_tree_aggregate_runs(
+    leaves,
+    n_leaves,
+    p_run_sizes,
+    p_runs,
+    nodes_increment,
+    aggregate_from_leaves
+  );
+
+  tree.leaves = tree.nodes;
+  tree.p_leaves = p_runs;
+  tree.leaf_size = 0;
+
+  tree.leaves_buffer = R_NilValue;
+  tree.p_leaves_buffer = NULL;
+  PROTECT(tree.leaves_buffer);
+
+  void* p_nodes = p_runs;
+  for (uint64_t i = 0; i < n_runs; ++i) {
+    p_nodes = nodes_increment(p_nodes);
+  }
+
+  tree.p_nodes = p_nodes;
+  tree.p_state = p_state;
+
+  tree.p_level = PROTECT(Rf_allocVector(RAWSXP, tree.n_levels * sizeof(void*)));
+  tree.p_p_level = (void**) RAW(tree.p_level);
+
+  tree.state_reset = state_reset;
+  tree.state_finalize = state_finalize;
+  tree.nodes_increment = nodes_increment;
+
+  // The leaves of the tree are nodes themselves
+  tree.aggregate_from_leaves = aggregate_from_nodes;
+  tree.aggregate_from_nodes = aggregate_from_nodes;
+
+  segment_tree_initialize_levels(&tree);
+
+  UNPROTECT(3);
+  return tree;
+}
+
+static void segment_tree_count_nodes(struct segment_tree* p_tree) {
+  p_tree->n_levels = 0;
+  p_tree->n_nodes = 0;
+
+  uint64_t n_level_nodes = p_tree->n_leaves;
+  while (n_level_nodes > 1) {
+    n_level_nodes = (uint64_t) ceil((double) n_level_nodes / SEGMENT_TREE_FANOUT);
+    p_tree->n_nodes += n_level_nodes;
+    ++p_tree->n_levels;
+  }
+}
+
+// Aggregates each run of `leaves` into its node of `p_runs`. Runs that span
+// chunks of ALTREP leaves are aggregated a chunk at a time, from left to
+// right, into the same node.
+static void segment_tree_aggregate_runs(SEXP leaves,
+                                        uint64_t n_leaves,
+                                        const int* p_run_sizes,
+                                        void* p_runs,
+                                        void* (*nodes_increment)(void* p_nodes),
+                                        void (*aggregate_from_leaves)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest)) {
+  const void* p_leaves = r_vec_deref_or_null(leaves);
+
+  SEXP buffer = R_NilValue;
+  void* p_buffer = NULL;
+
+  if (p_leaves == NULL) {
+    buffer = Rf_allocVector(RAWSXP, SEGMENT_TREE_LEAVES_CHUNK_SIZE * r_vec_elt_size(leaves));
+    p_buffer = (void*) RAW(buffer);
+  }
+  PROTECT(buffer);
+
+  void* p_dest = p_runs;
+  uint64_t run = 0;
+  uint64_t run_stop = n_leaves > 0 ? (uint64_t) p_run_sizes[0] : 0;
+
+  for (uint64_t i = 0; i < n_leaves; i += SEGMENT_TREE_LEAVES_CHUNK_SIZE) {
+    const uint64_t chunk_end = min_u64(n_leaves, i + SEGMENT_TREE_LEAVES_CHUNK_SIZE);
+
+    uint64_t offset = 0;
+    const void* p_source = p_leaves;
+
+    if (p_source == NULL) {
+      r_vec_get_region(leaves, i, chunk_end - i, p_buffer);
+      offset = i;
+      p_source = p_buffer;
+    }
+
+    uint64_t begin = i;
+
+    while (begin < chunk_end) {
+      while (begin == run_stop) {
+        p_dest = nodes_increment(p_dest);
+        ++run;
+        run_stop += p_run_sizes[run];
+      }
+
+      const uint64_t end = min_u64(run_stop, chunk_end);
+      aggregate_from_leaves(p_source, begin - offset, end - offset, p_dest);
+      begin = end;
+    }
+  }
+
+  UNPROTECT(1);
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Returns a pointer to leaves `[begin, end)`, shifted by `*p_offset`. When the
+ * leaves have a data pointer, this is just `p_leaves` with an offset of `0`.
+ * Otherwise the region is copied into the leaves buffer, so
+ * `end - begin <= SEGMENT_TREE_LEAVES_CHUNK_SIZE` is required.
+ */
+static inline const void* segment_tree_leaves_region(const struct segment_tree* p_tree,
+                                                     uint64_t begin,
+                                                     uint64_t end,
+                                                     uint64_t* p_offset) {
+  if (p_tree->p_leaves != NULL) {
+    *p_offset = 0;
+    return p_tree->p_leaves;
+  }
+
+  r_vec_get_region(p_tree->leaves, begin, end - begin, p_tree->p_leaves_buffer);
+
+  *p_offset = begin;
+  return p_tree->p_leaves_buffer;
+}
+
 // -----------------------------------------------------------------------------
 
 static void segment_tree_initialize_levels(struct segment_tree* p_tree) {
@@ -59,7 +252,6 @@ static void segment_tree_initialize_levels(struct segment_tree* p_tree) {
 
   uint64_t n_leaves = p_tree->n_leaves;
 
-  const void* p_leaves = p_tree->p_leaves;
   void* p_dest = p_tree->p_nodes;
 
   void** p_p_level = p_tree->p_p_level;
@@ -67,14 +259,21 @@ static void segment_tree_initialize_levels(struct segment_tree* p_tree) {
   p_p_level[0] = p_dest;
   uint64_t n_nodes_next_source = 0;
 
-  // Handle leaf aggregation
-  for (uint64_t i = 0; i < n_leaves; i += SEGMENT_TREE_FANOUT) {
-    uint64_t begin = i;
-    uint64_t end = min_u64(n_leaves, i + SEGMENT_TREE_FANOUT);
+  // Handle leaf aggregation, one chunk of leaves at a time
+  for (uint64_t i = 0; i < n_leaves; i += SEGMENT_TREE_LEAVES_CHUNK_SIZE) {
+    uint64_t chunk_end = min_u64(n_leaves, i + SEGMENT_TREE_LEAVES_CHUNK_SIZE);
+
+    uint64_t offset;
+    const void* p_leaves = segment_tree_leaves_region(p_tree, i, chunk_end, &offset);
+
+    for (uint64_t j = i; j < chunk_end; j += SEGMENT_TREE_FANOUT) {
+      uint64_t begin = j - offset;
+      uint64_t end = min_u64(chunk_end, j + SEGMENT_TREE_FANOUT) - offset;
 
-    p_tree->aggregate_from_leaves(p_leaves, begin, end, p_dest);
-    p_dest = p_tree->nodes_increment(p_dest);
-    ++n_nodes_next_source;
+      p_tree->aggregate_from_leaves(p_leaves, begin, end, p_dest);
+      p_dest = p_tree->nodes_increment(p_dest);
+      ++n_nodes_next_source;
+    }
   }
 
   void* p_source = p_p_level[0];
@@ -101,71 +300,125 @@ static void segment_tree_initialize_levels(struct segment_tree* p_tree) {
 
 // -----------------------------------------------------------------------------
 
-static void segment_tree_aggregate_level(const void* p_source,
-                                         void (*aggregate)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest),
+typedef void (*level_aggregate_fn)(const struct segment_tree* p_tree,
+                                   const void* p_source,
+                                   uint64_t begin,
+                                   uint64_t end,
+                                   void* p_state);
+
+// Deepest possible tree, plus the leaf level
+#define SEGMENT_TREE_MAX_LEVELS (64 / SEGMENT_TREE_FANOUT_POWER + 1)
+
+/*
+ * The ranges to the right of each level are only aggregated once every level
+ * has been visited, in reverse order, so the state sees the window strictly
+ * from left to right. This lets node types be merely associative, rather
+ * than also commutative.
+ */
+struct pending_ranges {
+  const void* p_sources[SEGMENT_TREE_MAX_LEVELS];
+  level_aggregate_fn aggregates[SEGMENT_TREE_MAX_LEVELS];
+  uint64_t begins[SEGMENT_TREE_MAX_LEVELS];
+  uint64_t ends[SEGMENT_TREE_MAX_LEVELS];
+  uint64_t size;
+};
+
+static void segment_tree_aggregate_level(const struct segment_tree* p_tree,
+                                         const void* p_source,
+                                         level_aggregate_fn aggregate,
                                          uint64_t* p_begin,
                                          uint64_t* p_end,
-                                         void* p_dest,
+                                         void* p_state,
+                                         struct pending_ranges* p_pending,
                                          bool* p_done);
 
+static void leaves_aggregate(const struct segment_tree* p_tree,
+                             const void* p_source,
+                             uint64_t begin,
+                             uint64_t end,
+                             void* p_state);
+static void nodes_aggregate(const struct segment_tree* p_tree,
+                            const void* p_source,
+                            uint64_t begin,
+                            uint64_t end,
+                            void* p_state);
+
 // [[ include("segment-tree.h") ]]
 void segment_tree_aggregate(const struct segment_tree* p_tree,
                             uint64_t begin,
                             uint64_t end,
                             void* p_result) {
+  segment_tree_aggregate_state(p_tree, begin, end, p_tree->p_state, p_result);
+}
+
+// Like `segment_tree_aggregate()`, but accumulates into `p_state` rather than
+// the state of the tree
+// [[ include("segment-tree.h") ]]
+void segment_tree_aggregate_state(const struct segment_tree* p_tree,
+                                  uint64_t begin,
+                                  uint64_t end,
+                                  void* p_state,
+                                  void* p_result) {
   bool done = false;
 
-  void* p_state = p_tree->p_state;
+  struct pending_ranges pending;
+  pending.size = 0;
 
   p_tree->state_reset(p_state);
 
-  const void* p_leaves = p_tree->p_leaves;
-
   // Aggregate leaf level
   segment_tree_aggregate_level(
-    p_leaves,
-    p_tree->aggregate_from_leaves,
+    p_tree,
+    NULL,
+    leaves_aggregate,
     &begin,
     &end,
     p_state,
+    &pending,
     &done
   );
 
-  if (done) {
-    p_tree->state_finalize(p_state, p_result);
-    return;
-  }
-
   void** p_p_level = p_tree->p_p_level;
   uint64_t n_levels = p_tree->n_levels;
 
   // Continue aggregation of node levels
-  for (uint64_t i = 0; i < n_levels; ++i) {
+  for (uint64_t i = 0; i < n_levels && !done; ++i) {
     const void* p_level = p_p_level[i];
 
     segment_tree_aggregate_level(
+      p_tree,
       p_level,
-      p_tree->aggregate_from_nodes,
+      nodes_aggregate,
       &begin,
       &end,
       p_state,
+      &pending,
       &done
     );
+  }
 
-    if (done) {
-      break;
-    }
+  // Finish with the pending right ranges, innermost first
+  for (uint64_t i = pending.size; i > 0; --i) {
+    pending.aggregates[i - 1](
+      p_tree,
+      pending.p_sources[i - 1],
+      pending.begins[i - 1],
+      pending.ends[i - 1],
+      p_state
+    );
   }
 
   p_tree->state_finalize(p_state, p_result);
   return;
 }
 
-static void segment_tree_aggregate_level(const void* p_source,
-                                         void (*aggregate)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest),
+static void segment_tree_aggregate_level(const struct segment_tree* p_tree,
+                                         const void* p_source,
+                                         level_aggregate_fn aggregate,
                                          uint64_t* p_begin,
                                          uint64_t* p_end,
                                          void* p_state,
+                                         struct pending_ranges* p_pending,
                                          bool* p_done) {
   uint64_t begin = *p_begin;
   uint64_t end = *p_end;
@@ -177,7 +430,7 @@ static void segment_tree_aggregate_level(const void* p_source,
 
   // Same fan group
   if (parent_begin == parent_end) {
-    aggregate(p_source, begin, end, p_state);
+    aggregate(p_tree, p_source, begin, end, p_state);
     *p_done = true;
     return;
   }
@@ -187,15 +440,40 @@ static void segment_tree_aggregate_level(const void* p_source,
 
   if (begin != group_begin) {
     uint64_t stop = group_begin + SEGMENT_TREE_FANOUT;
-    aggregate(p_source, begin, stop, p_state);
+    aggregate(p_tree, p_source, begin, stop, p_state);
     parent_begin += 1;
   }
 
   if (end != group_end) {
-    aggregate(p_source, group_end, end, p_state);
+    const uint64_t i = p_pending->size;
+    p_pending->p_sources[i] = p_source;
+    p_pending->aggregates[i] = aggregate;
+    p_pending->begins[i] = group_end;
+    p_pending->ends[i] = end;
+    ++p_pending->size;
   }
 
   // Update for next level
   *p_begin = parent_begin;
   *p_end = parent_end;
 }
+
+// Leaf level ranges never span more than one fan group, so they always fit
+// in the leaves buffer
+static void leaves_aggregate(const struct segment_tree* p_tree,
+                             const void* p_source,
+                             uint64_t begin,
+                             uint64_t end,
+                             void* p_state) {
+  uint64_t offset;
+  const void* p_leaves = segment_tree_leaves_region(p_tree, begin, end, &offset);
+  p_tree->aggregate_from_leaves(p_leaves, begin - offset, end - offset, p_state);
+}
+
+static void nodes_aggregate(const struct segment_tree* p_tree,
+                            const void* p_source,
+                            uint64_t begin,
+                            uint64_t end,
+                            void* p_state) {
+  p_tree->aggregate_from_nodes(p_source, begin, end, p_state);
+}
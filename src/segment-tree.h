@@ -2,12 +2,27 @@
 #define SLIDER_SEGMENT_TREE
 
 #include "slider.h"
+#include "summary-core-types.h"
 
 #define SEGMENT_TREE_FANOUT 16
 #define SEGMENT_TREE_FANOUT_POWER 4
 
+// Number of leaves pulled at once when the leaves don't have a data pointer
+// (i.e. unmaterialized ALTREP vectors). Must be a multiple of the fanout.
+#define SEGMENT_TREE_LEAVES_CHUNK_SIZE 4096
+
+// Mean size of the runs of `new_segment_tree_runs()` from which a tree is
+// built over the runs. Smaller runs would make a tree with more nodes than a
+// tree over the leaves.
+#define SEGMENT_TREE_RUNS_MIN_MEAN_SIZE SEGMENT_TREE_FANOUT
+
 struct segment_tree {
+  SEXP leaves;
   const void* p_leaves;
+  size_t leaf_size;
+
+  SEXP leaves_buffer;
+  void* p_leaves_buffer;
 
   SEXP p_level;
   void** p_p_level;
@@ -21,6 +36,9 @@ struct segment_tree {
   uint64_t n_levels;
   uint64_t n_nodes;
 
+  // Whether the leaves are the aggregated runs of `new_segment_tree_runs()`
+  bool runs;
+
   void (*state_reset)(void* p_state);
   void (*state_finalize)(void* p_state, void* p_result);
 
@@ -31,14 +49,15 @@ struct segment_tree {
 };
 
 #define PROTECT_SEGMENT_TREE(p_tree, p_n) do {  \
+  PROTECT((p_tree)->leaves_buffer);             \
   PROTECT((p_tree)->p_level);                   \
   PROTECT((p_tree)->nodes);                     \
-  *(p_n) += 2;                                  \
+  *(p_n) += 3;                                  \
 } while(0)
 
 
 struct segment_tree new_segment_tree(uint64_t n_leaves,
-                                     const void* p_leaves,
+                                     SEXP leaves,
                                      void* p_state,
                                      void (*state_reset)(void* p_state),
                                      void (*state_finalize)(void* p_state, void* p_result),
@@ -48,9 +67,46 @@ struct segment_tree new_segment_tree(uint64_t n_leaves,
                                      void (*aggregate_from_leaves)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest),
                                      void (*aggregate_from_nodes)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest));
 
+struct segment_tree new_segment_tree_runs(uint64_t n_leaves,
+                                          SEXP leaves,
+                                          uint64_t n_runs,
+                                          const int* p_run_sizes,
+                                          void* p_state,
+                                          void (*state_reset)(void* p_state),
+                                          void (*state_finalize)(void* p_state, void* p_result),
+                                          void* (*nodes_increment)(void* p_nodes),
+                                          SEXP (*nodes_initialize)(uint64_t n),
+                                          void* (*nodes_void_deref)(SEXP nodes),
+                                          void (*aggregate_from_leaves)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest),
+                                          void (*aggregate_from_nodes)(const void* p_source, uint64_t begin, uint64_t end, void* p_dest));
+
 void segment_tree_aggregate(const struct segment_tree* p_tree,
                             uint64_t begin,
                             uint64_t end,
                             void* p_result);
 
+// -----------------------------------------------------------------------------
+
+// Room for the state of a query, aligned for any of the states of
+// `summary-core-types.h`, which are checked against
+// `SEGMENT_TREE_STATE_MAX_SIZE` there
+union segment_tree_state {
+  long double align_long_double;
+  uint64_t align_uint64;
+  unsigned char data[SEGMENT_TREE_STATE_MAX_SIZE];
+};
+
+void segment_tree_aggregate_state(const struct segment_tree* p_tree,
+                                  uint64_t begin,
+                                  uint64_t end,
+                                  void* p_state,
+                                  void* p_result);
+
+// Queries only read the tree, apart from its state, unless the leaves are
+// pulled through the leaves buffer with the R API. Concurrent queries then
+// each bring their own state to `segment_tree_aggregate_state()`.
+static inline bool segment_tree_is_concurrent(const struct segment_tree* p_tree) {
+  return p_tree->p_leaves != NULL;
+}
+
 #endif
@@ -4,40 +4,72 @@
 #include "params.h"
 #include "assign.h"
 #include "opts-slide.h"
+#include "group.h"
+
+static SEXP slide_group_slice(const struct group_info* p_groups, SEXP x, int type);
 
 // -----------------------------------------------------------------------------
 
+/*
+ * When sliding by group, the rows of `x` have been reordered so that each
+ * group is contiguous. The iterations start over at each group, and windows
+ * are clamped to the rows of the group.
+ */
 #define SLIDE_LOOP(ASSIGN_ONE) do {                                            \
-  for (int i = iter_min; i < iter_max; i += iter_step) {                       \
-    if (i % 1024 == 0) {                                                       \
-      R_CheckUserInterrupt();                                                  \
-    }                                                                          \
+  int group_start = 0;                                                         \
                                                                                \
-    int window_start = max(start, 0);                                          \
-    int window_stop = min(stop, size - 1);                                     \
-    int window_size = window_stop - window_start + 1;                          \
+  for (R_xlen_t group = 0; group < n_groups; ++group) {                        \
+    const struct iter_opts iopts = iter_opts_group(&iopts_all, group);         \
+    const int group_size = iopts.size;                                         \
                                                                                \
-    /* Happens when the entire window is OOB, we take a 0-slice of `x`. */     \
-    if (window_stop < window_start) {                                          \
-      window_start = 0;                                                        \
-      window_size = 0;                                                         \
-    }                                                                          \
+    int iter_min = iopts.iter_min;                                             \
+    int iter_max = iopts.iter_max;                                             \
+    int iter_step = iopts.iter_step;                                           \
+                                                                               \
+    int start = iopts.start;                                                   \
+    int stop = iopts.stop;                                                     \
+                                                                               \
+    int start_step = iopts.start_step;                                         \
+    int stop_step = iopts.stop_step;                                           \
+                                                                               \
+    for (int i = iter_min; i < iter_max; i += iter_step) {                     \
+      const int position = group_start + i;                                    \
                                                                                \
-    start += start_step;                                                       \
-    stop += stop_step;                                                         \
+      if (position % 1024 == 0) {                                              \
+        R_CheckUserInterrupt();                                                \
+      }                                                                        \
                                                                                \
-    init_compact_seq(p_window, window_start, window_size, true);               \
+      int window_start = max(start, 0);                                        \
+      int window_stop = min(stop, group_size - 1);                             \
+      int window_size = window_stop - window_start + 1;                        \
                                                                                \
-    slice_and_update_env(x, window, env, type, container);                     \
+      /* Happens when the entire window is OOB, we take a 0-slice of `x`. */   \
+      if (window_stop < window_start) {                                        \
+        window_start = 0;                                                      \
+        window_size = 0;                                                       \
+      } else {                                                                 \
+        window_start += group_start;                                           \
+      }                                                                        \
                                                                                \
-    SEXP elt = PROTECT(r_force_eval(f_call, env, force));                      \
+      start += start_step;                                                     \
+      stop += stop_step;                                                       \
                                                                                \
-    if (atomic && vec_size(elt) != 1) {                                        \
-      stop_not_all_size_one(i + 1, vec_size(elt));                             \
+      init_compact_seq(p_window, window_start, window_size, true);             \
+                                                                               \
+      slice_and_update_env(x, window, env, type, container);                   \
+                                                                               \
+      SEXP elt = PROTECT(r_force_eval(f_call, env, force));                    \
+                                                                               \
+      if (atomic && vec_size(elt) != 1) {                                      \
+        const int location = group_info_location(&groups, position + 1);      \
+        stop_not_all_size_one(location, vec_size(elt));                        \
+      }                                                                        \
+                                                                               \
+      ASSIGN_ONE(p_out, position, elt, ptype);                                 \
+      UNPROTECT(1);                                                            \
     }                                                                          \
                                                                                \
-    ASSIGN_ONE(p_out, i, elt, ptype);                                          \
-    UNPROTECT(1);                                                              \
+    group_start += group_size;                                                 \
   }                                                                            \
 } while(0)
 
@@ -68,6 +100,7 @@ SEXP slide_common_impl(SEXP x,
                        SEXP ptype,
                        SEXP env,
                        SEXP params) {
+  int n_prot = 0;
 
   const int type = validate_type(r_lst_get(params, 0));
   const bool constrain = validate_constrain(r_lst_get(params, 1));
@@ -80,10 +113,11 @@ SEXP slide_common_impl(SEXP x,
   SEXP after = r_lst_get(params, 4);
   SEXP step = r_lst_get(params, 5);
   SEXP complete = r_lst_get(params, 6);
+  SEXP by = r_lst_get(params, 7);
 
   const bool dot = true;
 
-  const struct slide_opts opts = new_slide_opts(
+  struct slide_opts opts = new_slide_opts(
     before,
     after,
     step,
@@ -91,27 +125,30 @@ SEXP slide_common_impl(SEXP x,
     dot
   );
 
-  const struct iter_opts iopts = new_iter_opts(opts, size);
+  // Without `by`, `groups` is a single group and only used to locate rows
+  struct group_info groups = new_group_info(R_NilValue, R_NilValue);
+
+  if (by != R_NilValue) {
+    groups = new_group_info_by(by, size, ".by");
+    PROTECT_GROUP_INFO(&groups, &n_prot);
 
-  int iter_min = iopts.iter_min;
-  int iter_max = iopts.iter_max;
-  int iter_step = iopts.iter_step;
+    opts.p_groups = &groups;
 
-  int start = iopts.start;
-  int stop = iopts.stop;
+    x = PROTECT_N(slide_group_slice(&groups, x, type), &n_prot);
+  }
 
-  int start_step = iopts.start_step;
-  int stop_step = iopts.stop_step;
+  const struct iter_opts iopts_all = new_iter_opts(opts, size);
+  const R_xlen_t n_groups = iter_opts_n_groups(&iopts_all);
 
   // The indices to slice x with
-  SEXP window = PROTECT(compact_seq(0, 0, true));
+  SEXP window = PROTECT_N(compact_seq(0, 0, true), &n_prot);
   int* p_window = INTEGER(window);
 
   // Mutable container for the results of slicing x
-  SEXP container = PROTECT(make_slice_container(type));
+  SEXP container = PROTECT_N(make_slice_container(type), &n_prot);
 
   SEXPTYPE out_type = TYPEOF(ptype);
-  SEXP out = PROTECT(slider_init(out_type, size));
+  SEXP out = PROTECT_N(slider_init(out_type, size), &n_prot);
 
   switch (out_type) {
   case INTSXP:  SLIDE_LOOP_ATOMIC(int, INTEGER, assign_one_int); break;
@@ -125,7 +162,30 @@ SEXP slide_common_impl(SEXP x,
   SEXP names = slider_names(x, type);
   Rf_setAttrib(out, R_NamesSymbol, names);
 
-  UNPROTECT(3);
+  out = group_info_restore(&groups, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// Reorders the rows of `x`, or of each of the vectors of `x` for `slide2()`
+// and `pslide()`, so that each group is contiguous
+static SEXP slide_group_slice(const struct group_info* p_groups, SEXP x, int type) {
+  if (type == SLIDE) {
+    return group_info_slice(p_groups, x);
+  }
+
+  const R_xlen_t n = Rf_xlength(x);
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, n));
+
+  for (R_xlen_t j = 0; j < n; ++j) {
+    SET_VECTOR_ELT(out, j, group_info_slice(p_groups, VECTOR_ELT(x, j)));
+  }
+
+  Rf_setAttrib(out, R_NamesSymbol, Rf_getAttrib(x, R_NamesSymbol));
+
+  UNPROTECT(1);
   return out;
 }
 
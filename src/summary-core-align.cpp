@@ -18,4 +18,24 @@ size_t align_of_mean_state_t() {
   return alignof(struct mean_state_t);
 }
 
+size_t align_of_int64_t() {
+  return alignof(int64_t);
+}
+
+size_t align_of_mean_int_state_t() {
+  return alignof(struct mean_int_state_t);
+}
+
+size_t align_of_moment_state_t() {
+  return alignof(struct moment_state_t);
+}
+
+size_t align_of_log_prod_state_t() {
+  return alignof(struct log_prod_state_t);
+}
+
+size_t align_of_drawdown_state_t() {
+  return alignof(struct drawdown_state_t);
+}
+
 } // extern "C"
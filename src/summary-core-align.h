@@ -9,6 +9,11 @@ extern "C" {
 
 size_t align_of_long_double();
 size_t align_of_mean_state_t();
+size_t align_of_int64_t();
+size_t align_of_mean_int_state_t();
+size_t align_of_moment_state_t();
+size_t align_of_log_prod_state_t();
+size_t align_of_drawdown_state_t();
 
 } // extern "C"
 
@@ -8,4 +8,58 @@ struct mean_state_t {
   uint64_t count;
 };
 
+struct mean_int_state_t {
+  int64_t sum;
+  uint64_t count;
+};
+
+// Count, mean, and sums of the 2nd through 4th powers of the deviations
+// from the mean
+struct moment_state_t {
+  uint64_t count;
+  long double mean;
+  long double m2;
+  long double m3;
+  long double m4;
+};
+
+// Sum of the logs of the absolute values of the non-zero elements, along with
+// the number of elements, zeros, and negative values
+struct log_prod_state_t {
+  long double log_sum;
+  uint64_t count;
+  uint64_t n_zero;
+  uint64_t n_negative;
+};
+
+// Largest and smallest values, along with the largest decline from a value to
+// any value after it
+struct drawdown_state_t {
+  double max;
+  double min;
+  double drawdown;
+};
+
+// -----------------------------------------------------------------------------
+
+// Upper bound on the size of the states above. Concurrent segment tree
+// queries each get this much room for their state, see
+// `union segment_tree_state`.
+#define SEGMENT_TREE_STATE_MAX_SIZE 128
+
+// Fails to compile when a state doesn't fit. A negative array size rather
+// than `_Static_assert()`, which is C11 only, and is also included from C++.
+#define SEGMENT_TREE_STATE_CHECK_SIZE(type, name) \
+  typedef char segment_tree_state_fits_##name[(sizeof(type) <= SEGMENT_TREE_STATE_MAX_SIZE) ? 1 : -1]
+
+SEGMENT_TREE_STATE_CHECK_SIZE(long double, long_double);
+SEGMENT_TREE_STATE_CHECK_SIZE(int64_t, int64_t);
+SEGMENT_TREE_STATE_CHECK_SIZE(struct mean_state_t, mean_state_t);
+SEGMENT_TREE_STATE_CHECK_SIZE(struct mean_int_state_t, mean_int_state_t);
+SEGMENT_TREE_STATE_CHECK_SIZE(struct moment_state_t, moment_state_t);
+SEGMENT_TREE_STATE_CHECK_SIZE(struct log_prod_state_t, log_prod_state_t);
+SEGMENT_TREE_STATE_CHECK_SIZE(struct drawdown_state_t, drawdown_state_t);
+
+#undef SEGMENT_TREE_STATE_CHECK_SIZE
+
 #endif
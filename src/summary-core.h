@@ -4,10 +4,43 @@
 #include "slider.h"
 #include "summary-core-types.h"
 #include "align.h"
+#include "utils.h"
 
 // From `summary-core-align.hpp`
 size_t align_of_long_double();
 size_t align_of_mean_state_t();
+size_t align_of_int64_t();
+size_t align_of_mean_int_state_t();
+size_t align_of_moment_state_t();
+size_t align_of_log_prod_state_t();
+size_t align_of_drawdown_state_t();
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Bare integer and logical vectors are aggregated natively by the sum, mean,
+ * min, and max trees rather than being cast to double. With fewer than 2^32
+ * leaves, an `int64_t` sum of them can't overflow, as every non-missing
+ * integer is at most `2^31 - 1` in absolute value. This also means the sum
+ * can never reach `INT64_MIN`, which we use as the missing value sentinel.
+ *
+ * Objects, like factors, still go through `vec_cast()` to double so they
+ * error as before.
+ */
+#define SUMMARY_INT_MAX_SIZE ((uint64_t) 1 << 32)
+#define SUMMARY_INT_NA INT64_MIN
+
+static inline SEXP summary_leaves_ptype(SEXP x) {
+  if (OBJECT(x) || (uint64_t) Rf_xlength(x) >= SUMMARY_INT_MAX_SIZE) {
+    return slider_shared_empty_dbl;
+  }
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: return slider_shared_empty_lgl;
+  case INTSXP: return slider_shared_empty_int;
+  default: return slider_shared_empty_dbl;
+  }
+}
 
 // -----------------------------------------------------------------------------
 // Sum
@@ -137,6 +170,127 @@ static inline void sum_na_rm_aggregate_from_nodes(const void* p_source,
   }
 }
 
+// -----------------------------------------------------------------------------
+// Sum - integer leaves
+
+static inline void sum_int_state_reset(void* p_state) {
+  int64_t* p_state_ = (int64_t*) p_state;
+  *p_state_ = 0;
+}
+
+static inline void sum_int_state_finalize(void* p_state, void* p_result) {
+  double* p_result_ = (double*) p_result;
+  const int64_t state = *((int64_t*) p_state);
+
+  if (state == SUMMARY_INT_NA) {
+    *p_result_ = NA_REAL;
+  } else {
+    *p_result_ = (double) state;
+  }
+
+  return;
+}
+
+static inline void* sum_int_nodes_increment(void* p_nodes) {
+  return (void*) (((int64_t*) p_nodes) + 1);
+}
+
+static inline void* sum_int_nodes_void_deref(SEXP nodes) {
+  return aligned_void_deref(nodes, align_of_int64_t());
+}
+static inline int64_t* sum_int_nodes_deref(SEXP nodes) {
+  return (int64_t*) sum_int_nodes_void_deref(nodes);
+}
+
+static inline SEXP sum_int_nodes_initialize(uint64_t n) {
+  SEXP nodes = PROTECT(aligned_allocate(n, sizeof(int64_t), align_of_int64_t()));
+  int64_t* p_nodes = sum_int_nodes_deref(nodes);
+
+  for (uint64_t i = 0; i < n; ++i) {
+    p_nodes[i] = 0;
+  }
+
+  UNPROTECT(1);
+  return nodes;
+}
+
+static inline void sum_int_na_keep_aggregate_from_leaves(const void* p_source,
+                                                         uint64_t begin,
+                                                         uint64_t end,
+                                                         void* p_dest) {
+  const int* p_source_ = (const int*) p_source;
+  int64_t* p_dest_ = (int64_t*) p_dest;
+
+  // If already NA, nothing can change it
+  if (*p_dest_ == SUMMARY_INT_NA) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int elt = p_source_[i];
+
+    if (elt == NA_INTEGER) {
+      *p_dest_ = SUMMARY_INT_NA;
+      return;
+    }
+
+    *p_dest_ += elt;
+  }
+}
+
+static inline void sum_int_na_keep_aggregate_from_nodes(const void* p_source,
+                                                        uint64_t begin,
+                                                        uint64_t end,
+                                                        void* p_dest) {
+  const int64_t* p_source_ = (const int64_t*) p_source;
+  int64_t* p_dest_ = (int64_t*) p_dest;
+
+  // If already NA, nothing can change it
+  if (*p_dest_ == SUMMARY_INT_NA) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int64_t elt = p_source_[i];
+
+    if (elt == SUMMARY_INT_NA) {
+      *p_dest_ = SUMMARY_INT_NA;
+      return;
+    }
+
+    *p_dest_ += elt;
+  }
+}
+
+static inline void sum_int_na_rm_aggregate_from_leaves(const void* p_source,
+                                                       uint64_t begin,
+                                                       uint64_t end,
+                                                       void* p_dest) {
+  const int* p_source_ = (const int*) p_source;
+  int64_t* p_dest_ = (int64_t*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int elt = p_source_[i];
+
+    if (elt != NA_INTEGER) {
+      *p_dest_ += elt;
+    }
+  }
+}
+
+static inline void sum_int_na_rm_aggregate_from_nodes(const void* p_source,
+                                                      uint64_t begin,
+                                                      uint64_t end,
+                                                      void* p_dest) {
+  const int64_t* p_source_ = (const int64_t*) p_source;
+  int64_t* p_dest_ = (int64_t*) p_dest;
+
+  // Nodes never hold the NA sentinel when `NA`s are removed
+  for (uint64_t i = begin; i < end; ++i) {
+    *p_dest_ += p_source_[i];
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Prod
 
@@ -265,6 +419,195 @@ static inline void prod_na_rm_aggregate_from_nodes(const void* p_source,
   }
 }
 
+// -----------------------------------------------------------------------------
+// Log prod
+
+/*
+ * The log domain product and the geometric mean share a node type. Products
+ * become sums of `log(|x|)`, which can't overflow however long the window
+ * is, while zeros and the signs of the values are counted on the side.
+ *
+ * Missing values are tracked through the log sum, like the sum of the mean
+ * nodes.
+ */
+
+static inline void log_prod_state_reset(void* p_state) {
+  struct log_prod_state_t* p_state_ = (struct log_prod_state_t*) p_state;
+  p_state_->log_sum = 0;
+  p_state_->count = 0;
+  p_state_->n_zero = 0;
+  p_state_->n_negative = 0;
+}
+
+// `0 * Inf` is `NaN`, like `prod()`
+static inline void log_prod_state_finalize(void* p_state, void* p_result) {
+  struct log_prod_state_t* p_state_ = (struct log_prod_state_t*) p_state;
+  double* p_result_ = (double*) p_result;
+
+  const long double log_sum = p_state_->log_sum;
+
+  if (isnan(log_sum)) {
+    *p_result_ = (double) log_sum;
+    return;
+  }
+
+  const double sign = p_state_->n_negative % 2 == 0 ? 1 : -1;
+
+  if (p_state_->n_zero > 0) {
+    *p_result_ = log_sum == INFINITY ? R_NaN : sign * 0;
+    return;
+  }
+
+  *p_result_ = sign * (double) expl(log_sum);
+  return;
+}
+
+// `exp(mean(log(x)))`, so negative values give `NaN` and zeros give `0`,
+// unless there is also an `Inf`
+static inline void geomean_state_finalize(void* p_state, void* p_result) {
+  struct log_prod_state_t* p_state_ = (struct log_prod_state_t*) p_state;
+  double* p_result_ = (double*) p_result;
+
+  const long double log_sum = p_state_->log_sum;
+
+  if (isnan(log_sum)) {
+    *p_result_ = (double) log_sum;
+    return;
+  }
+
+  if (p_state_->n_negative > 0) {
+    *p_result_ = R_NaN;
+    return;
+  }
+
+  if (p_state_->n_zero > 0) {
+    *p_result_ = log_sum == INFINITY ? R_NaN : 0;
+    return;
+  }
+
+  *p_result_ = (double) expl(log_sum / p_state_->count);
+  return;
+}
+
+static inline void* log_prod_nodes_increment(void* p_nodes) {
+  return (void*) (((struct log_prod_state_t*) p_nodes) + 1);
+}
+
+static inline void* log_prod_nodes_void_deref(SEXP nodes) {
+  return aligned_void_deref(nodes, align_of_log_prod_state_t());
+}
+static inline struct log_prod_state_t* log_prod_nodes_deref(SEXP nodes) {
+  return (struct log_prod_state_t*) log_prod_nodes_void_deref(nodes);
+}
+
+static inline SEXP log_prod_nodes_initialize(uint64_t n) {
+  SEXP nodes = PROTECT(aligned_allocate(n, sizeof(struct log_prod_state_t), align_of_log_prod_state_t()));
+  struct log_prod_state_t* p_nodes = log_prod_nodes_deref(nodes);
+
+  for (uint64_t i = 0; i < n; ++i) {
+    log_prod_state_reset(p_nodes + i);
+  }
+
+  UNPROTECT(1);
+  return nodes;
+}
+
+// `elt` must not be missing. The log of each element is only taken in double
+// precision, the sum is kept in long double.
+static inline void log_prod_push(struct log_prod_state_t* p_dest, double elt) {
+  if (elt == 0) {
+    ++p_dest->n_zero;
+  } else {
+    p_dest->log_sum += log(fabs(elt));
+  }
+
+  p_dest->n_negative += elt < 0;
+  ++p_dest->count;
+}
+
+static inline void log_prod_merge(struct log_prod_state_t* p_dest, const struct log_prod_state_t* p_source) {
+  p_dest->log_sum += p_source->log_sum;
+  p_dest->count += p_source->count;
+  p_dest->n_zero += p_source->n_zero;
+  p_dest->n_negative += p_source->n_negative;
+}
+
+static inline void log_prod_na_keep_aggregate_from_leaves(const void* p_source,
+                                                          uint64_t begin,
+                                                          uint64_t end,
+                                                          void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  struct log_prod_state_t* p_dest_ = (struct log_prod_state_t*) p_dest;
+
+  // If already NaN or NA, nothing can change it
+  if (isnan(p_dest_->log_sum)) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const double elt = p_source_[i];
+
+    if (isnan(elt)) {
+      p_dest_->log_sum = elt;
+      return;
+    }
+
+    log_prod_push(p_dest_, elt);
+  }
+}
+
+static inline void log_prod_na_keep_aggregate_from_nodes(const void* p_source,
+                                                         uint64_t begin,
+                                                         uint64_t end,
+                                                         void* p_dest) {
+  const struct log_prod_state_t* p_source_ = (const struct log_prod_state_t*) p_source;
+  struct log_prod_state_t* p_dest_ = (struct log_prod_state_t*) p_dest;
+
+  // If already NaN or NA, nothing can change it
+  if (isnan(p_dest_->log_sum)) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const long double log_sum = p_source_[i].log_sum;
+
+    if (isnan(log_sum)) {
+      p_dest_->log_sum = log_sum;
+      return;
+    }
+
+    log_prod_merge(p_dest_, p_source_ + i);
+  }
+}
+
+static inline void log_prod_na_rm_aggregate_from_leaves(const void* p_source,
+                                                        uint64_t begin,
+                                                        uint64_t end,
+                                                        void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  struct log_prod_state_t* p_dest_ = (struct log_prod_state_t*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const double elt = p_source_[i];
+
+    if (!isnan(elt)) {
+      log_prod_push(p_dest_, elt);
+    }
+  }
+}
+
+static inline void log_prod_na_rm_aggregate_from_nodes(const void* p_source,
+                                                       uint64_t begin,
+                                                       uint64_t end,
+                                                       void* p_dest) {
+  const struct log_prod_state_t* p_source_ = (const struct log_prod_state_t*) p_source;
+  struct log_prod_state_t* p_dest_ = (struct log_prod_state_t*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    log_prod_merge(p_dest_, p_source_ + i);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Mean
 
@@ -391,6 +734,347 @@ static inline void mean_na_rm_aggregate_from_nodes(const void* p_source,
   }
 }
 
+// -----------------------------------------------------------------------------
+// Mean - integer leaves
+
+static inline void mean_int_state_reset(void* p_state) {
+  struct mean_int_state_t* p_state_ = (struct mean_int_state_t*) p_state;
+  p_state_->sum = 0;
+  p_state_->count = 0;
+}
+
+static inline void mean_int_state_finalize(void* p_state, void* p_result) {
+  struct mean_int_state_t* p_state_ = (struct mean_int_state_t*) p_state;
+  double* p_result_ = (double*) p_result;
+
+  if (p_state_->sum == SUMMARY_INT_NA) {
+    *p_result_ = NA_REAL;
+  } else {
+    *p_result_ = (double) ((long double) p_state_->sum / p_state_->count);
+  }
+
+  return;
+}
+
+static inline void* mean_int_nodes_increment(void* p_nodes) {
+  return (void*) (((struct mean_int_state_t*) p_nodes) + 1);
+}
+
+static inline void* mean_int_nodes_void_deref(SEXP nodes) {
+  return aligned_void_deref(nodes, align_of_mean_int_state_t());
+}
+static inline struct mean_int_state_t* mean_int_nodes_deref(SEXP nodes) {
+  return (struct mean_int_state_t*) mean_int_nodes_void_deref(nodes);
+}
+
+static inline SEXP mean_int_nodes_initialize(uint64_t n) {
+  SEXP nodes = PROTECT(aligned_allocate(n, sizeof(struct mean_int_state_t), align_of_mean_int_state_t()));
+  struct mean_int_state_t* p_nodes = mean_int_nodes_deref(nodes);
+
+  for (uint64_t i = 0; i < n; ++i) {
+    p_nodes[i].sum = 0;
+    p_nodes[i].count = 0;
+  }
+
+  UNPROTECT(1);
+  return nodes;
+}
+
+static inline void mean_int_na_keep_aggregate_from_leaves(const void* p_source,
+                                                          uint64_t begin,
+                                                          uint64_t end,
+                                                          void* p_dest) {
+  const int* p_source_ = (const int*) p_source;
+  struct mean_int_state_t* p_dest_ = (struct mean_int_state_t*) p_dest;
+
+  // If already NA, nothing can change it
+  if (p_dest_->sum == SUMMARY_INT_NA) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int elt = p_source_[i];
+
+    if (elt == NA_INTEGER) {
+      // No need to worry about count
+      p_dest_->sum = SUMMARY_INT_NA;
+      return;
+    }
+
+    p_dest_->sum += elt;
+    ++p_dest_->count;
+  }
+}
+
+static inline void mean_int_na_keep_aggregate_from_nodes(const void* p_source,
+                                                         uint64_t begin,
+                                                         uint64_t end,
+                                                         void* p_dest) {
+  const struct mean_int_state_t* p_source_ = (const struct mean_int_state_t*) p_source;
+  struct mean_int_state_t* p_dest_ = (struct mean_int_state_t*) p_dest;
+
+  // If already NA, nothing can change it
+  if (p_dest_->sum == SUMMARY_INT_NA) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int64_t sum = p_source_[i].sum;
+
+    if (sum == SUMMARY_INT_NA) {
+      // No need to worry about count
+      p_dest_->sum = SUMMARY_INT_NA;
+      return;
+    }
+
+    p_dest_->sum += sum;
+    p_dest_->count += p_source_[i].count;
+  }
+}
+
+static inline void mean_int_na_rm_aggregate_from_leaves(const void* p_source,
+                                                        uint64_t begin,
+                                                        uint64_t end,
+                                                        void* p_dest) {
+  const int* p_source_ = (const int*) p_source;
+  struct mean_int_state_t* p_dest_ = (struct mean_int_state_t*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int elt = p_source_[i];
+
+    if (elt != NA_INTEGER) {
+      p_dest_->sum += elt;
+      ++p_dest_->count;
+    }
+  }
+}
+
+static inline void mean_int_na_rm_aggregate_from_nodes(const void* p_source,
+                                                       uint64_t begin,
+                                                       uint64_t end,
+                                                       void* p_dest) {
+  const struct mean_int_state_t* p_source_ = (const struct mean_int_state_t*) p_source;
+  struct mean_int_state_t* p_dest_ = (struct mean_int_state_t*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    p_dest_->sum += p_source_[i].sum;
+    p_dest_->count += p_source_[i].count;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Moments
+
+/*
+ * Skewness and kurtosis share a node type holding the central moment sums of
+ * their elements. Leaves are pushed one at a time with Welford's update, and
+ * nodes are merged with Pebay's pairwise update formulas, so no large powers
+ * of the raw values are ever summed and subtracted.
+ *
+ * Missing values are tracked through the mean, like the sum of the mean
+ * nodes.
+ */
+
+static inline void moment_state_reset(void* p_state) {
+  struct moment_state_t* p_state_ = (struct moment_state_t*) p_state;
+  p_state_->count = 0;
+  p_state_->mean = 0;
+  p_state_->m2 = 0;
+  p_state_->m3 = 0;
+  p_state_->m4 = 0;
+}
+
+// `m3 / m2^(3/2)` of the central moments, `NaN` for constant or empty windows
+static inline void skew_state_finalize(void* p_state, void* p_result) {
+  struct moment_state_t* p_state_ = (struct moment_state_t*) p_state;
+  double* p_result_ = (double*) p_result;
+
+  if (isnan(p_state_->mean)) {
+    *p_result_ = (double) p_state_->mean;
+    return;
+  }
+
+  const long double n = p_state_->count;
+  const long double m2 = p_state_->m2 / n;
+  const long double m3 = p_state_->m3 / n;
+
+  *p_result_ = (double) (m3 / (m2 * sqrtl(m2)));
+  return;
+}
+
+// `m4 / m2^2 - 3` of the central moments, `NaN` for constant or empty windows
+static inline void kurt_state_finalize(void* p_state, void* p_result) {
+  struct moment_state_t* p_state_ = (struct moment_state_t*) p_state;
+  double* p_result_ = (double*) p_result;
+
+  if (isnan(p_state_->mean)) {
+    *p_result_ = (double) p_state_->mean;
+    return;
+  }
+
+  const long double n = p_state_->count;
+  const long double m2 = p_state_->m2 / n;
+  const long double m4 = p_state_->m4 / n;
+
+  *p_result_ = (double) (m4 / (m2 * m2) - 3);
+  return;
+}
+
+static inline void* moment_nodes_increment(void* p_nodes) {
+  return (void*) (((struct moment_state_t*) p_nodes) + 1);
+}
+
+static inline void* moment_nodes_void_deref(SEXP nodes) {
+  return aligned_void_deref(nodes, align_of_moment_state_t());
+}
+static inline struct moment_state_t* moment_nodes_deref(SEXP nodes) {
+  return (struct moment_state_t*) moment_nodes_void_deref(nodes);
+}
+
+static inline SEXP moment_nodes_initialize(uint64_t n) {
+  SEXP nodes = PROTECT(aligned_allocate(n, sizeof(struct moment_state_t), align_of_moment_state_t()));
+  struct moment_state_t* p_nodes = moment_nodes_deref(nodes);
+
+  for (uint64_t i = 0; i < n; ++i) {
+    moment_state_reset(p_nodes + i);
+  }
+
+  UNPROTECT(1);
+  return nodes;
+}
+
+static inline void moment_push(struct moment_state_t* p_dest, double elt) {
+  const uint64_t count = p_dest->count + 1;
+  const long double n = count;
+
+  const long double delta = elt - p_dest->mean;
+  const long double delta_n = delta / n;
+  const long double delta_n2 = delta_n * delta_n;
+  const long double term = delta * delta_n * (n - 1);
+
+  p_dest->m4 += term * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * p_dest->m2 - 4 * delta_n * p_dest->m3;
+  p_dest->m3 += term * delta_n * (n - 2) - 3 * delta_n * p_dest->m2;
+  p_dest->m2 += term;
+  p_dest->mean += delta_n;
+  p_dest->count = count;
+}
+
+static inline void moment_merge(struct moment_state_t* p_dest, const struct moment_state_t* p_source) {
+  if (p_source->count == 0) {
+    return;
+  }
+  if (p_dest->count == 0) {
+    *p_dest = *p_source;
+    return;
+  }
+
+  const long double n_a = p_dest->count;
+  const long double n_b = p_source->count;
+  const long double n = n_a + n_b;
+
+  const long double delta = p_source->mean - p_dest->mean;
+  const long double delta_n = delta / n;
+  const long double delta_n2 = delta_n * delta_n;
+
+  const long double m2_a = p_dest->m2;
+  const long double m2_b = p_source->m2;
+  const long double m3_a = p_dest->m3;
+  const long double m3_b = p_source->m3;
+
+  p_dest->m4 += p_source->m4 +
+    delta * delta_n * delta_n2 * n_a * n_b * (n_a * n_a - n_a * n_b + n_b * n_b) +
+    6 * delta_n2 * (n_a * n_a * m2_b + n_b * n_b * m2_a) +
+    4 * delta_n * (n_a * m3_b - n_b * m3_a);
+
+  p_dest->m3 += m3_b +
+    delta * delta_n2 * n_a * n_b * (n_a - n_b) +
+    3 * delta_n * (n_a * m2_b - n_b * m2_a);
+
+  p_dest->m2 += m2_b + delta * delta_n * n_a * n_b;
+  p_dest->mean += delta_n * n_b;
+  p_dest->count += p_source->count;
+}
+
+static inline void moment_na_keep_aggregate_from_leaves(const void* p_source,
+                                                        uint64_t begin,
+                                                        uint64_t end,
+                                                        void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  struct moment_state_t* p_dest_ = (struct moment_state_t*) p_dest;
+
+  // If already NaN or NA, nothing can change it
+  if (isnan(p_dest_->mean)) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const double elt = p_source_[i];
+
+    if (isnan(elt)) {
+      // No need to worry about the other moments
+      p_dest_->mean = elt;
+      return;
+    }
+
+    moment_push(p_dest_, elt);
+  }
+}
+
+static inline void moment_na_keep_aggregate_from_nodes(const void* p_source,
+                                                       uint64_t begin,
+                                                       uint64_t end,
+                                                       void* p_dest) {
+  const struct moment_state_t* p_source_ = (const struct moment_state_t*) p_source;
+  struct moment_state_t* p_dest_ = (struct moment_state_t*) p_dest;
+
+  // If already NaN or NA, nothing can change it
+  if (isnan(p_dest_->mean)) {
+    return;
+  }
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const long double mean = p_source_[i].mean;
+
+    if (isnan(mean)) {
+      // No need to worry about the other moments
+      p_dest_->mean = mean;
+      return;
+    }
+
+    moment_merge(p_dest_, p_source_ + i);
+  }
+}
+
+static inline void moment_na_rm_aggregate_from_leaves(const void* p_source,
+                                                      uint64_t begin,
+                                                      uint64_t end,
+                                                      void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  struct moment_state_t* p_dest_ = (struct moment_state_t*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const double elt = p_source_[i];
+
+    if (!isnan(elt)) {
+      moment_push(p_dest_, elt);
+    }
+  }
+}
+
+static inline void moment_na_rm_aggregate_from_nodes(const void* p_source,
+                                                     uint64_t begin,
+                                                     uint64_t end,
+                                                     void* p_dest) {
+  const struct moment_state_t* p_source_ = (const struct moment_state_t*) p_source;
+  struct moment_state_t* p_dest_ = (struct moment_state_t*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    // Don't skip `NaN` nodes. Faster and more correct, this way we propagate
+    // node `NaN` values resulting from `Inf - Inf`
+    moment_merge(p_dest_, p_source_ + i);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Min
 
@@ -483,6 +1167,43 @@ static inline void min_na_rm_aggregate_from_nodes(const void* p_source,
   min_na_rm_aggregate_from_leaves(p_source, begin, end, p_dest);
 }
 
+// Integer leaves are aggregated into the same double nodes
+
+static inline void min_int_na_keep_aggregate_from_leaves(const void* p_source,
+                                                         uint64_t begin,
+                                                         uint64_t end,
+                                                         void* p_dest) {
+  const int* p_source_ = (const int*) p_source;
+  double* p_dest_ = (double*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int elt = p_source_[i];
+
+    if (elt == NA_INTEGER) {
+      *p_dest_ = NA_REAL;
+      break;
+    } else if (elt < *p_dest_) {
+      *p_dest_ = elt;
+    }
+  }
+}
+
+static inline void min_int_na_rm_aggregate_from_leaves(const void* p_source,
+                                                       uint64_t begin,
+                                                       uint64_t end,
+                                                       void* p_dest) {
+  const int* p_source_ = (const int*) p_source;
+  double* p_dest_ = (double*) p_dest;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const int elt = p_source_[i];
+
+    if (elt != NA_INTEGER && elt < *p_dest_) {
+      *p_dest_ = elt;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Max
 
@@ -575,210 +1296,285 @@ static inline void max_na_rm_aggregate_from_nodes(const void* p_source,
   max_na_rm_aggregate_from_leaves(p_source, begin, end, p_dest);
 }
 
-// -----------------------------------------------------------------------------
-// All
-
-static inline void all_state_reset(void* p_state) {
-  int* p_state_ = (int*) p_state;
-  *p_state_ = 1;
-}
-
-static inline void all_state_finalize(void* p_state, void* p_result) {
-  int* p_result_ = (int*) p_result;
-  const int state = *((int*) p_state);
-  *p_result_ = state;
-  return;
-}
-
-static inline void* all_nodes_increment(void* p_nodes) {
-  return (void*) (((int*) p_nodes) + 1);
-}
-
-static inline int* all_nodes_deref(SEXP nodes) {
-  return LOGICAL(nodes);
-}
-static inline void* all_nodes_void_deref(SEXP nodes) {
-  return (void*) all_nodes_deref(nodes);
-}
-
-static inline SEXP all_nodes_initialize(uint64_t n) {
-  SEXP nodes = PROTECT(Rf_allocVector(LGLSXP, n));
-  int* p_nodes = all_nodes_deref(nodes);
-
-  for (uint64_t i = 0; i < n; ++i) {
-    p_nodes[i] = 1;
-  }
-
-  UNPROTECT(1);
-  return nodes;
-}
+// Integer leaves are aggregated into the same double nodes
 
-static inline void all_na_keep_aggregate_from_leaves(const void* p_source,
-                                                     uint64_t begin,
-                                                     uint64_t end,
-                                                     void* p_dest) {
+static inline void max_int_na_keep_aggregate_from_leaves(const void* p_source,
+                                                         uint64_t begin,
+                                                         uint64_t end,
+                                                         void* p_dest) {
   const int* p_source_ = (const int*) p_source;
-  int* p_dest_ = (int*) p_dest;
-
-  // If already FALSE, we are done.
-  // FALSE-ness overrides any potential NAs.
-  if (!*p_dest_) {
-    return;
-  }
+  double* p_dest_ = (double*) p_dest;
 
   for (uint64_t i = begin; i < end; ++i) {
     const int elt = p_source_[i];
 
-    if (!elt) {
-      *p_dest_ = 0;
-      return;
-    }
-
-    if (elt == NA_LOGICAL) {
-      *p_dest_ = NA_LOGICAL;
-      continue;
+    if (elt == NA_INTEGER) {
+      *p_dest_ = NA_REAL;
+      break;
+    } else if (elt > *p_dest_) {
+      *p_dest_ = elt;
     }
   }
 }
 
-static inline void all_na_keep_aggregate_from_nodes(const void* p_source,
-                                                    uint64_t begin,
-                                                    uint64_t end,
-                                                    void* p_dest) {
-  all_na_keep_aggregate_from_leaves(p_source, begin, end, p_dest);
-}
-
-static inline void all_na_rm_aggregate_from_leaves(const void* p_source,
-                                                   uint64_t begin,
-                                                   uint64_t end,
-                                                   void* p_dest) {
+static inline void max_int_na_rm_aggregate_from_leaves(const void* p_source,
+                                                       uint64_t begin,
+                                                       uint64_t end,
+                                                       void* p_dest) {
   const int* p_source_ = (const int*) p_source;
-  int* p_dest_ = (int*) p_dest;
-
-  // If already FALSE, we are done.
-  if (!*p_dest_) {
-    return;
-  }
+  double* p_dest_ = (double*) p_dest;
 
   for (uint64_t i = begin; i < end; ++i) {
     const int elt = p_source_[i];
 
-    if (!elt) {
-      *p_dest_ = 0;
-      return;
+    if (elt != NA_INTEGER && elt > *p_dest_) {
+      *p_dest_ = elt;
     }
   }
 }
 
-static inline void all_na_rm_aggregate_from_nodes(const void* p_source,
-                                                  uint64_t begin,
-                                                  uint64_t end,
-                                                  void* p_dest) {
-  all_na_rm_aggregate_from_leaves(p_source, begin, end, p_dest);
+// -----------------------------------------------------------------------------
+// Drawdown
+
+/*
+ * The maximum drawdown of a range is the largest decline from any of its
+ * values to a later one. It isn't a function of the max and min alone, but
+ * the `(max, min, drawdown)` triples of two adjacent ranges merge into the
+ * triple of their union, since the only new decline is from the max of the
+ * left range to the min of the right one. The merge is associative but not
+ * commutative, which the segment tree respects by aggregating from left to
+ * right. The range of the window shares these nodes.
+ *
+ * Missing values are tracked through the drawdown, like `min()` and `max()`.
+ */
+
+static inline void drawdown_state_reset(void* p_state) {
+  struct drawdown_state_t* p_state_ = (struct drawdown_state_t*) p_state;
+  p_state_->max = R_NegInf;
+  p_state_->min = R_PosInf;
+  p_state_->drawdown = 0;
+}
+
+// `0` for empty windows and windows of one value
+static inline void drawdown_state_finalize(void* p_state, void* p_result) {
+  struct drawdown_state_t* p_state_ = (struct drawdown_state_t*) p_state;
+  double* p_result_ = (double*) p_result;
+  *p_result_ = p_state_->drawdown;
+  return;
 }
 
-// -----------------------------------------------------------------------------
-// Any
+// `max(x) - min(x)`, so `-Inf` for empty windows
+static inline void range_state_finalize(void* p_state, void* p_result) {
+  struct drawdown_state_t* p_state_ = (struct drawdown_state_t*) p_state;
+  double* p_result_ = (double*) p_result;
 
-static inline void any_state_reset(void* p_state) {
-  int* p_state_ = (int*) p_state;
-  *p_state_ = 0;
-}
+  if (isnan(p_state_->drawdown)) {
+    *p_result_ = p_state_->drawdown;
+    return;
+  }
 
-static inline void any_state_finalize(void* p_state, void* p_result) {
-  int* p_result_ = (int*) p_result;
-  const int state = *((int*) p_state);
-  *p_result_ = state;
+  *p_result_ = p_state_->max - p_state_->min;
   return;
 }
 
-static inline void* any_nodes_increment(void* p_nodes) {
-  return (void*) (((int*) p_nodes) + 1);
+static inline void* drawdown_nodes_increment(void* p_nodes) {
+  return (void*) (((struct drawdown_state_t*) p_nodes) + 1);
 }
 
-static inline int* any_nodes_deref(SEXP nodes) {
-  return LOGICAL(nodes);
+static inline void* drawdown_nodes_void_deref(SEXP nodes) {
+  return aligned_void_deref(nodes, align_of_drawdown_state_t());
 }
-static inline void* any_nodes_void_deref(SEXP nodes) {
-  return (void*) any_nodes_deref(nodes);
+static inline struct drawdown_state_t* drawdown_nodes_deref(SEXP nodes) {
+  return (struct drawdown_state_t*) drawdown_nodes_void_deref(nodes);
 }
 
-static inline SEXP any_nodes_initialize(uint64_t n) {
-  SEXP nodes = PROTECT(Rf_allocVector(LGLSXP, n));
-  int* p_nodes = any_nodes_deref(nodes);
+static inline SEXP drawdown_nodes_initialize(uint64_t n) {
+  SEXP nodes = PROTECT(aligned_allocate(n, sizeof(struct drawdown_state_t), align_of_drawdown_state_t()));
+  struct drawdown_state_t* p_nodes = drawdown_nodes_deref(nodes);
 
   for (uint64_t i = 0; i < n; ++i) {
-    p_nodes[i] = 0;
+    drawdown_state_reset(p_nodes + i);
   }
 
   UNPROTECT(1);
   return nodes;
 }
 
-static inline void any_na_keep_aggregate_from_leaves(const void* p_source,
-                                                     uint64_t begin,
-                                                     uint64_t end,
-                                                     void* p_dest) {
-  const int* p_source_ = (const int*) p_source;
-  int* p_dest_ = (int*) p_dest;
+/*
+ * Appends the range summarized by `max`, `min`, and `drawdown` to the right of
+ * `p_dest`. A single value is its own max and min, with no drawdown. The
+ * decline is only computed when there is one, which avoids `Inf - Inf`.
+ */
+static inline void drawdown_append(struct drawdown_state_t* p_dest,
+                                   double max,
+                                   double min,
+                                   double drawdown) {
+  if (p_dest->max > min) {
+    const double decline = p_dest->max - min;
+
+    if (decline > p_dest->drawdown) {
+      p_dest->drawdown = decline;
+    }
+  }
+
+  if (drawdown > p_dest->drawdown) {
+    p_dest->drawdown = drawdown;
+  }
+  if (max > p_dest->max) {
+    p_dest->max = max;
+  }
+  if (min < p_dest->min) {
+    p_dest->min = min;
+  }
+}
+
+static inline void drawdown_na_keep_aggregate_from_leaves(const void* p_source,
+                                                          uint64_t begin,
+                                                          uint64_t end,
+                                                          void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  struct drawdown_state_t* p_dest_ = (struct drawdown_state_t*) p_dest;
 
-  // If already TRUE, we are done.
-  // TRUE-ness overrides any potential NAs.
-  if (*p_dest_ == 1) {
+  // Nothing trumps an `NA`
+  if (ISNA(p_dest_->drawdown)) {
     return;
   }
 
   for (uint64_t i = begin; i < end; ++i) {
-    const int elt = p_source_[i];
+    const double elt = p_source_[i];
 
-    if (!elt) {
-      continue;
+    if (isnan(elt)) {
+      /* Match R - any `NA` trumps `NaN` */
+      if (ISNA(elt)) {
+        p_dest_->drawdown = NA_REAL;
+        return;
+      } else {
+        p_dest_->drawdown = R_NaN;
+      }
+    } else if (!isnan(p_dest_->drawdown)) {
+      drawdown_append(p_dest_, elt, elt, 0);
     }
+  }
+}
 
-    if (elt == NA_LOGICAL) {
-      *p_dest_ = NA_LOGICAL;
-      continue;
-    }
+static inline void drawdown_na_keep_aggregate_from_nodes(const void* p_source,
+                                                         uint64_t begin,
+                                                         uint64_t end,
+                                                         void* p_dest) {
+  const struct drawdown_state_t* p_source_ = (const struct drawdown_state_t*) p_source;
+  struct drawdown_state_t* p_dest_ = (struct drawdown_state_t*) p_dest;
 
-    *p_dest_ = 1;
+  // Nothing trumps an `NA`
+  if (ISNA(p_dest_->drawdown)) {
     return;
   }
-}
 
-static inline void any_na_keep_aggregate_from_nodes(const void* p_source,
-                                                    uint64_t begin,
-                                                    uint64_t end,
-                                                    void* p_dest) {
-  any_na_keep_aggregate_from_leaves(p_source, begin, end, p_dest);
+  for (uint64_t i = begin; i < end; ++i) {
+    const struct drawdown_state_t elt = p_source_[i];
+
+    if (isnan(elt.drawdown)) {
+      /* Match R - any `NA` trumps `NaN` */
+      if (ISNA(elt.drawdown)) {
+        p_dest_->drawdown = NA_REAL;
+        return;
+      } else {
+        p_dest_->drawdown = R_NaN;
+      }
+    } else if (!isnan(p_dest_->drawdown)) {
+      drawdown_append(p_dest_, elt.max, elt.min, elt.drawdown);
+    }
+  }
 }
 
-static inline void any_na_rm_aggregate_from_leaves(const void* p_source,
-                                                   uint64_t begin,
-                                                   uint64_t end,
-                                                   void* p_dest) {
-  const int* p_source_ = (const int*) p_source;
-  int* p_dest_ = (int*) p_dest;
+static inline void drawdown_na_rm_aggregate_from_leaves(const void* p_source,
+                                                        uint64_t begin,
+                                                        uint64_t end,
+                                                        void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  struct drawdown_state_t* p_dest_ = (struct drawdown_state_t*) p_dest;
 
-  // If already TRUE, we are done.
-  if (*p_dest_ == 1) {
-    return;
+  for (uint64_t i = begin; i < end; ++i) {
+    const double elt = p_source_[i];
+
+    if (!isnan(elt)) {
+      drawdown_append(p_dest_, elt, elt, 0);
+    }
   }
+}
+
+static inline void drawdown_na_rm_aggregate_from_nodes(const void* p_source,
+                                                       uint64_t begin,
+                                                       uint64_t end,
+                                                       void* p_dest) {
+  const struct drawdown_state_t* p_source_ = (const struct drawdown_state_t*) p_source;
+  struct drawdown_state_t* p_dest_ = (struct drawdown_state_t*) p_dest;
 
   for (uint64_t i = begin; i < end; ++i) {
-    const int elt = p_source_[i];
+    const struct drawdown_state_t elt = p_source_[i];
+    drawdown_append(p_dest_, elt.max, elt.min, elt.drawdown);
+  }
+}
 
-    if (elt == 1) {
-      *p_dest_ = 1;
+// -----------------------------------------------------------------------------
+// Exponentially weighted mean
+
+/*
+ * Decayed sum of the values and of their weights. Decaying both by the same
+ * factor and dividing at the end gives the exponentially weighted mean, with
+ * the weights normalized over the values seen so far. Both stay bounded, so
+ * there is no loss of precision from a growing normalization constant.
+ */
+struct ewma_state {
+  long double sum;
+  long double weight;
+  bool na;
+  bool nan;
+};
+
+static inline struct ewma_state new_ewma_state() {
+  struct ewma_state state = { .sum = 0, .weight = 0, .na = false, .nan = false };
+  return state;
+}
+
+static inline void ewma_decay(struct ewma_state* p_state, long double decay) {
+  p_state->sum *= decay;
+  p_state->weight *= decay;
+}
+
+static inline void ewma_push(struct ewma_state* p_state, double value, bool na_rm) {
+  if (isnan(value)) {
+    if (na_rm) {
       return;
     }
+
+    /* Match R - any `NA` trumps `NaN` */
+    if (ISNA(value)) {
+      p_state->na = true;
+    } else {
+      p_state->nan = true;
+    }
+
+    return;
   }
+
+  p_state->sum += value;
+  p_state->weight += 1;
 }
 
-static inline void any_na_rm_aggregate_from_nodes(const void* p_source,
-                                                  uint64_t begin,
-                                                  uint64_t end,
-                                                  void* p_dest) {
-  any_na_rm_aggregate_from_leaves(p_source, begin, end, p_dest);
+static inline double ewma_state_finalize(const struct ewma_state* p_state) {
+  if (p_state->na) {
+    return NA_REAL;
+  }
+  if (p_state->nan) {
+    return R_NaN;
+  }
+
+  // No values seen yet, only possible with `na_rm = TRUE`
+  if (p_state->weight == 0) {
+    return NA_REAL;
+  }
+
+  return (double) (p_state->sum / p_state->weight);
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,162 @@
+#include "slider.h"
+#include "slider-vctrs.h"
+#include "utils.h"
+#include "params.h"
+#include "group.h"
+#include "summary-core.h"
+
+// Number of values pulled at once when `x` doesn't have a data pointer
+// (i.e. unmaterialized ALTREP vectors)
+#define EWMA_CHUNK_SIZE 4096
+
+/*
+ * A single pass over `x`. The window of each element is unbounded on the
+ * left, so rather than aggregating it again for every element, the state is
+ * decayed by the distance to the next element before that element is added.
+ *
+ * With `p_i == NULL`, the distance between neighbouring elements is always 1.
+ * Otherwise `p_i` is the ascending numeric index of `x`, and elements sharing
+ * an index value are added together and share the same result, like any
+ * other peer group of `slide_index()`.
+ *
+ * When sliding by group, the rows of `x` have been reordered so that each
+ * group is contiguous, and the state starts over at the first row of each
+ * group.
+ */
+static void ewma_fill(SEXP x,
+                      R_xlen_t size,
+                      const double* p_i,
+                      double half_life,
+                      bool na_rm,
+                      const struct group_info* p_groups,
+                      double* p_out) {
+  const double* p_x = (const double*) r_vec_deref_or_null(x);
+
+  SEXP buffer = R_NilValue;
+  double* p_buffer = NULL;
+
+  if (p_x == NULL) {
+    buffer = Rf_allocVector(REALSXP, EWMA_CHUNK_SIZE);
+    p_buffer = REAL(buffer);
+  }
+  PROTECT(buffer);
+
+  const long double unit_decay = powl(2, -1 / (long double) half_life);
+
+  struct ewma_state state = new_ewma_state();
+
+  R_xlen_t chunk_begin = 0;
+  R_xlen_t chunk_end = 0;
+
+  R_xlen_t group = -1;
+  R_xlen_t group_stop = 0;
+
+  R_xlen_t peers_start = 0;
+
+  for (R_xlen_t j = 0; j < size; ++j) {
+    if (j % 1024 == 0) {
+      R_CheckUserInterrupt();
+    }
+
+    if (j == group_stop) {
+      ++group;
+      group_stop += group_info_size(p_groups, group, size);
+      state = new_ewma_state();
+    } else {
+      if (p_i == NULL) {
+        ewma_decay(&state, unit_decay);
+      } else if (p_i[j] != p_i[j - 1]) {
+        ewma_decay(&state, powl(2, -(p_i[j] - p_i[j - 1]) / (long double) half_life));
+      }
+    }
+
+    double elt;
+
+    if (p_x != NULL) {
+      elt = p_x[j];
+    } else {
+      if (j >= chunk_end) {
+        chunk_begin = j;
+        chunk_end = min_size(size, j + EWMA_CHUNK_SIZE);
+        r_vec_get_region(x, chunk_begin, chunk_end - chunk_begin, p_buffer);
+      }
+      elt = p_buffer[j - chunk_begin];
+    }
+
+    ewma_push(&state, elt, na_rm);
+
+    // Peers are only complete once the next index value differs
+    const bool peers_done = p_i == NULL || j == group_stop - 1 || p_i[j + 1] != p_i[j];
+
+    if (!peers_done) {
+      continue;
+    }
+
+    const double result = ewma_state_finalize(&state);
+
+    for (R_xlen_t k = peers_start; k <= j; ++k) {
+      p_out[k] = result;
+    }
+
+    peers_start = j + 1;
+  }
+
+  UNPROTECT(1);
+}
+
+static SEXP ewma(SEXP x,
+                 SEXP i,
+                 SEXP half_life,
+                 SEXP na_rm,
+                 const struct group_info* p_groups) {
+  double c_half_life = validate_half_life(half_life);
+  bool c_na_rm = validate_na_rm(na_rm, false);
+
+  // Before `vec_cast()`, which may drop names
+  SEXP names = PROTECT(slider_names(x, SLIDE));
+
+  x = PROTECT(vec_cast(x, slider_shared_empty_dbl));
+
+  const R_xlen_t size = Rf_xlength(x);
+  const double* p_i = (i == R_NilValue) ? NULL : REAL_RO(i);
+
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, size));
+  double* p_out = REAL(out);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  ewma_fill(x, size, p_i, c_half_life, c_na_rm, p_groups, p_out);
+
+  UNPROTECT(3);
+  return out;
+}
+
+// [[ register() ]]
+SEXP slider_ewma(SEXP x, SEXP half_life, SEXP na_rm, SEXP by) {
+  if (by == R_NilValue) {
+    struct group_info groups = new_group_info(R_NilValue, R_NilValue);
+    return ewma(x, R_NilValue, half_life, na_rm, &groups);
+  }
+
+  int n_prot = 0;
+
+  struct group_info groups = new_group_info_by(by, vec_size(x), "by");
+  PROTECT_GROUP_INFO(&groups, &n_prot);
+
+  x = PROTECT_N(group_info_slice(&groups, x), &n_prot);
+
+  SEXP out = PROTECT_N(ewma(x, R_NilValue, half_life, na_rm, &groups), &n_prot);
+  out = group_info_restore(&groups, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// `i` has already been checked and converted to a double vector in the units
+// of `half_life`. When sliding by group, `x` and `i` have already been
+// reordered so that each group is contiguous, and `group_sizes` holds the size
+// of each group.
+// [[ register() ]]
+SEXP slider_index_ewma(SEXP x, SEXP i, SEXP half_life, SEXP na_rm, SEXP group_sizes) {
+  struct group_info groups = new_group_info(group_sizes, R_NilValue);
+  return ewma(x, i, half_life, na_rm, &groups);
+}
@@ -0,0 +1,393 @@
+#include "slider.h"
+#include "slider-vctrs.h"
+#include "opts-slide.h"
+#include "utils.h"
+#include "params.h"
+#include "bitmap.h"
+#include "group.h"
+
+/*
+ * Kernels with at least this many taps per computed window are applied with
+ * FFT based convolution. Below that, the direct dot product of each window is
+ * faster than the transforms.
+ */
+#define FILTER_FFT_MIN_TAPS 64
+
+/*
+ * The dot product of a window with the weights. Four independent
+ * accumulators break the dependency chain on a single sum, which lets the
+ * compiler keep several multiply-adds in flight (or vectorize them) without
+ * having to reorder floating point additions itself.
+ */
+static inline double filter_dot(const double* p_x, const double* p_weights, R_xlen_t n) {
+  double acc0 = 0;
+  double acc1 = 0;
+  double acc2 = 0;
+  double acc3 = 0;
+
+  R_xlen_t k = 0;
+
+  for (; k + 4 <= n; k += 4) {
+    acc0 += p_x[k] * p_weights[k];
+    acc1 += p_x[k + 1] * p_weights[k + 1];
+    acc2 += p_x[k + 2] * p_weights[k + 2];
+    acc3 += p_x[k + 3] * p_weights[k + 3];
+  }
+
+  double out = (acc0 + acc1) + (acc2 + acc3);
+
+  for (; k < n; ++k) {
+    out += p_x[k] * p_weights[k];
+  }
+
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * In place iterative radix-2 FFT of `n` complex values, `n` being a power of
+ * two. `p_cos` and `p_sin` hold the `n / 2` twiddle factors
+ * `cos(2 * pi * k / n)` and `sin(2 * pi * k / n)`. The inverse transform is
+ * not scaled by `1 / n`.
+ */
+static void fft(double* p_re,
+                double* p_im,
+                const double* p_cos,
+                const double* p_sin,
+                R_xlen_t n,
+                bool inverse) {
+  // Bit reversal permutation
+  for (R_xlen_t i = 1, j = 0; i < n; ++i) {
+    R_xlen_t bit = n >> 1;
+
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+
+    if (i < j) {
+      double tmp = p_re[i];
+      p_re[i] = p_re[j];
+      p_re[j] = tmp;
+
+      tmp = p_im[i];
+      p_im[i] = p_im[j];
+      p_im[j] = tmp;
+    }
+  }
+
+  const double sign = inverse ? 1 : -1;
+
+  for (R_xlen_t len = 2; len <= n; len <<= 1) {
+    const R_xlen_t half = len >> 1;
+    const R_xlen_t stride = n / len;
+
+    for (R_xlen_t i = 0; i < n; i += len) {
+      for (R_xlen_t j = 0; j < half; ++j) {
+        const double w_re = p_cos[j * stride];
+        const double w_im = sign * p_sin[j * stride];
+
+        const R_xlen_t u = i + j;
+        const R_xlen_t v = u + half;
+
+        const double v_re = p_re[v] * w_re - p_im[v] * w_im;
+        const double v_im = p_re[v] * w_im + p_im[v] * w_re;
+
+        p_re[v] = p_re[u] - v_re;
+        p_im[v] = p_im[u] - v_im;
+
+        p_re[u] += v_re;
+        p_im[u] += v_im;
+      }
+    }
+  }
+}
+
+/*
+ * Overlap-add convolution of `x` with the reversed `weights`. For each
+ * position `i`, `p_out[i]` is the dot product of the weights with the full
+ * window `[i - before, i + after]`, where positions outside of `x` count as
+ * zero.
+ *
+ * `x` is cut into blocks of `block_size` values, and each block is convolved
+ * with a transform of size `n_fft`, large enough to hold the whole linear
+ * convolution of a block. Since the kernel is real, two blocks are packed into
+ * the real and imaginary parts of a single transform and come back out of the
+ * real and imaginary parts of the result.
+ */
+static void filter_fft(const double* p_x,
+                       R_xlen_t size,
+                       const double* p_weights,
+                       R_xlen_t n_weights,
+                       R_xlen_t after,
+                       double* p_out) {
+  R_xlen_t n_fft = 1;
+  while (n_fft < 2 * n_weights) {
+    n_fft <<= 1;
+  }
+
+  const R_xlen_t block_size = n_fft - n_weights + 1;
+
+  SEXP workspace = PROTECT(Rf_allocVector(REALSXP, 5 * n_fft));
+  double* p_kernel_re = REAL(workspace);
+  double* p_kernel_im = p_kernel_re + n_fft;
+  double* p_re = p_kernel_im + n_fft;
+  double* p_im = p_re + n_fft;
+  double* p_cos = p_im + n_fft;
+  double* p_sin = p_cos + n_fft / 2;
+
+  const double theta = 2 * M_PI / n_fft;
+
+  for (R_xlen_t k = 0; k < n_fft / 2; ++k) {
+    p_cos[k] = cos(theta * k);
+    p_sin[k] = sin(theta * k);
+  }
+
+  // Reversed, so the convolution lines the weights up with the window.
+  // Scaling by `1 / n_fft` here saves doing it on every inverse transform.
+  for (R_xlen_t k = 0; k < n_fft; ++k) {
+    p_kernel_re[k] = k < n_weights ? p_weights[n_weights - 1 - k] / n_fft : 0;
+    p_kernel_im[k] = 0;
+  }
+
+  fft(p_kernel_re, p_kernel_im, p_cos, p_sin, n_fft, false);
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    p_out[i] = 0;
+  }
+
+  // The convolution at `c` is the window of the output at `c - after`
+  const R_xlen_t n_conv = size + n_weights - 1;
+
+  for (R_xlen_t begin = 0; begin < size; begin += 2 * block_size) {
+    R_CheckUserInterrupt();
+
+    const R_xlen_t begin_im = begin + block_size;
+
+    for (R_xlen_t k = 0; k < n_fft; ++k) {
+      p_re[k] = (k < block_size && begin + k < size) ? p_x[begin + k] : 0;
+      p_im[k] = (k < block_size && begin_im + k < size) ? p_x[begin_im + k] : 0;
+    }
+
+    fft(p_re, p_im, p_cos, p_sin, n_fft, false);
+
+    for (R_xlen_t k = 0; k < n_fft; ++k) {
+      const double re = p_re[k] * p_kernel_re[k] - p_im[k] * p_kernel_im[k];
+      const double im = p_re[k] * p_kernel_im[k] + p_im[k] * p_kernel_re[k];
+      p_re[k] = re;
+      p_im[k] = im;
+    }
+
+    fft(p_re, p_im, p_cos, p_sin, n_fft, true);
+
+    for (R_xlen_t k = 0; k < n_fft; ++k) {
+      const R_xlen_t c_re = begin + k;
+      const R_xlen_t c_im = begin_im + k;
+
+      const R_xlen_t i_re = c_re - after;
+      const R_xlen_t i_im = c_im - after;
+
+      if (c_re < n_conv && i_re >= 0 && i_re < size) {
+        p_out[i_re] += p_re[k];
+      }
+      if (c_im < n_conv && i_im >= 0 && i_im < size) {
+        p_out[i_im] += p_im[k];
+      }
+    }
+  }
+
+  UNPROTECT(1);
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Missing values are zeroed out of `p_x` so they can't poison the FFT. When
+ * they aren't removed, a window holding one instead takes the first missing
+ * value of the window from `x`, like `slide_sum()`. A cursor over the missing
+ * bitmap resumes its search where the previous window left off.
+ *
+ * When sliding by group, the rows of `x` have been reordered so that each
+ * group is contiguous, and each group is filtered on its own, with its own
+ * transform.
+ */
+static void filter_fill(SEXP x,
+                        R_xlen_t size,
+                        const double* p_weights,
+                        R_xlen_t n_weights,
+                        struct slide_opts opts,
+                        bool na_rm,
+                        double* p_out) {
+  int n_prot = 0;
+
+  SEXP values = PROTECT_N(Rf_allocVector(REALSXP, size), &n_prot);
+  double* p_x = REAL(values);
+  r_vec_get_region(x, 0, size, p_x);
+
+  bool any_missing = false;
+  bool any_infinite = false;
+
+  for (R_xlen_t k = 0; k < size; ++k) {
+    const double elt = p_x[k];
+
+    if (isnan(elt)) {
+      any_missing = true;
+      p_x[k] = 0;
+    } else if (!isfinite(elt)) {
+      any_infinite = true;
+    }
+  }
+
+  struct lgl_bitmap missing = { 0 };
+
+  if (any_missing && !na_rm) {
+    missing = new_missing_bitmap(x);
+    PROTECT_LGL_BITMAP(&missing, &n_prot);
+  }
+
+  const struct iter_opts iopts_all = new_iter_opts(opts, size);
+  const R_xlen_t n_groups = iter_opts_n_groups(&iopts_all);
+
+  // Infinite values would spread through the whole transform of their block
+  const bool can_use_fft =
+    !any_infinite &&
+    size >= n_weights &&
+    n_weights >= (R_xlen_t) FILTER_FFT_MIN_TAPS * iopts_all.iter_step;
+
+  double* p_filtered = NULL;
+
+  if (can_use_fft) {
+    SEXP filtered = PROTECT_N(Rf_allocVector(REALSXP, size), &n_prot);
+    p_filtered = REAL(filtered);
+  }
+
+  R_xlen_t missing_position = 0;
+  R_xlen_t group_start = 0;
+
+  for (R_xlen_t group = 0; group < n_groups; ++group) {
+    const struct iter_opts iopts = iter_opts_group(&iopts_all, group);
+    const R_xlen_t group_size = iopts.size;
+
+    const bool use_fft = can_use_fft && group_size >= n_weights;
+
+    if (use_fft) {
+      filter_fft(
+        p_x + group_start,
+        group_size,
+        p_weights,
+        n_weights,
+        opts.after,
+        p_filtered + group_start
+      );
+    }
+
+    for (R_xlen_t i = iopts.iter_min; i < iopts.iter_max; i += iopts.iter_step) {
+      const R_xlen_t position = group_start + i;
+
+      if (position % 1024 == 0) {
+        R_CheckUserInterrupt();
+      }
+
+      const R_xlen_t begin = i - opts.before;
+      const R_xlen_t window_start = max_size(begin, 0);
+      const R_xlen_t window_stop = min_size(i + opts.after + 1, group_size);
+
+      if (window_stop <= window_start) {
+        p_out[position] = 0;
+        continue;
+      }
+
+      const R_xlen_t start = group_start + window_start;
+      const R_xlen_t stop = group_start + window_stop;
+
+      if (any_missing && !na_rm && lgl_bitmap_count_na(&missing, start, stop)) {
+        missing_position = max_size(missing_position, start);
+
+        while (!lgl_bitmap_is_na(&missing, missing_position)) {
+          ++missing_position;
+        }
+
+        r_vec_get_region(x, missing_position, 1, p_out + position);
+        continue;
+      }
+
+      if (use_fft) {
+        p_out[position] = p_filtered[position];
+      } else {
+        p_out[position] = filter_dot(
+          p_x + start,
+          p_weights + (window_start - begin),
+          window_stop - window_start
+        );
+      }
+    }
+
+    group_start += group_size;
+  }
+
+  UNPROTECT(n_prot);
+}
+
+// -----------------------------------------------------------------------------
+
+// [[ register() ]]
+SEXP slider_filter(SEXP x,
+                   SEXP weights,
+                   SEXP before,
+                   SEXP after,
+                   SEXP step,
+                   SEXP complete,
+                   SEXP na_rm,
+                   SEXP by) {
+  int n_prot = 0;
+
+  bool dot = false;
+  struct slide_opts opts = new_slide_opts(before, after, step, complete, dot);
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  weights = PROTECT_N(validate_weights(weights), &n_prot);
+  const R_xlen_t n_weights = Rf_xlength(weights);
+
+  if (opts.before_unbounded || opts.after_unbounded) {
+    Rf_errorcall(R_NilValue, "`before` and `after` must be finite in a filter.");
+  }
+
+  const R_xlen_t width = (R_xlen_t) opts.before + opts.after + 1;
+
+  if (n_weights != width) {
+    Rf_errorcall(
+      R_NilValue,
+      "`weights` must have size %.0f, the width of the window, not %.0f.",
+      (double) width,
+      (double) n_weights
+    );
+  }
+
+  struct group_info groups = new_group_info(R_NilValue, R_NilValue);
+
+  if (by != R_NilValue) {
+    groups = new_group_info_by(by, vec_size(x), "by");
+    PROTECT_GROUP_INFO(&groups, &n_prot);
+    opts.p_groups = &groups;
+    x = PROTECT_N(group_info_slice(&groups, x), &n_prot);
+  }
+
+  // Before `vec_cast()`, which may drop names
+  SEXP names = PROTECT_N(slider_names(x, SLIDE), &n_prot);
+
+  x = PROTECT_N(vec_cast(x, slider_shared_empty_dbl), &n_prot);
+
+  const R_xlen_t size = Rf_xlength(x);
+
+  SEXP out = PROTECT_N(slider_init(REALSXP, size), &n_prot);
+  double* p_out = REAL(out);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  filter_fill(x, size, REAL_RO(weights), n_weights, opts, c_na_rm, p_out);
+
+  out = group_info_restore(&groups, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
@@ -3,8 +3,15 @@
 #include "utils.h"
 #include "params.h"
 #include "index.h"
+#include "columns.h"
 #include "segment-tree.h"
+#include "parallel.h"
+#include "bitmap.h"
+#include "window-position.h"
+#include "window-rank.h"
+#include "window-category.h"
 #include "summary-core.h"
+#include "query-counts.h"
 
 // -----------------------------------------------------------------------------
 
@@ -32,7 +39,7 @@ static SEXP slider_index_summary(SEXP x,
 
 // -----------------------------------------------------------------------------
 
-typedef void (*summary_index_impl_dbl_fn)(const double* p_x,
+typedef void (*summary_index_impl_dbl_fn)(SEXP x,
                                           R_xlen_t size,
                                           int iter_min,
                                           int iter_max,
@@ -44,7 +51,7 @@ typedef void (*summary_index_impl_dbl_fn)(const double* p_x,
                                           struct index_info* p_index,
                                           double* p_out);
 
-typedef void (*summary_index_impl_lgl_fn)(const int* p_x,
+typedef void (*summary_index_impl_lgl_fn)(SEXP x,
                                           R_xlen_t size,
                                           int iter_min,
                                           int iter_max,
@@ -56,22 +63,26 @@ typedef void (*summary_index_impl_lgl_fn)(const int* p_x,
                                           struct index_info* p_index,
                                           int* p_out);
 
+typedef void (*summary_index_impl_int_fn)(SEXP x,
+                                          R_xlen_t size,
+                                          int iter_min,
+                                          int iter_max,
+                                          const struct range_info range,
+                                          const int* p_peer_sizes,
+                                          const int* p_peer_starts,
+                                          const int* p_peer_stops,
+                                          bool na_rm,
+                                          struct index_info* p_index,
+                                          int* p_out);
 
-#define SLIDE_INDEX_SUMMARY(PTYPE, CTYPE, SEXPTYPE, CONST_DEREF, DEREF) do { \
+
+/*
+ * The windows are located once, and shared by each `column` of `x` that
+ * `PTYPE` is evaluated for, see `columns.h`
+ */
+#define SLIDE_INDEX_SUMMARY(PTYPE, CTYPE, SEXPTYPE, DEREF) do {              \
   int n_prot = 0;                                                            \
                                                                              \
-  /* Before `vec_cast()`, which may drop names */                            \
-  SEXP names = PROTECT_N(slider_names(x, SLIDE), &n_prot);                   \
-                                                                             \
-  x = PROTECT_N(vec_cast(x, PTYPE), &n_prot);                                \
-  const CTYPE* p_x = CONST_DEREF(x);                                         \
-                                                                             \
-  const R_xlen_t size = Rf_xlength(x);                                       \
-                                                                             \
-  SEXP out = PROTECT_N(slider_init(SEXPTYPE, size), &n_prot);                \
-  CTYPE* p_out = DEREF(out);                                                 \
-  Rf_setAttrib(out, R_NamesSymbol, names);                                   \
-                                                                             \
   struct index_info index = new_index_info(i);                               \
   PROTECT_INDEX_INFO(&index, &n_prot);                                       \
                                                                              \
@@ -86,19 +97,46 @@ typedef void (*summary_index_impl_lgl_fn)(const int* p_x,
   const int iter_min = compute_min_iteration(index, range, complete);        \
   const int iter_max = compute_max_iteration(index, range, complete);        \
                                                                              \
-  fn(                                                                        \
-    p_x,                                                                     \
-    size,                                                                    \
-    iter_min,                                                                \
-    iter_max,                                                                \
-    range,                                                                   \
-    p_peer_sizes,                                                            \
-    p_peer_starts,                                                           \
-    p_peer_stops,                                                            \
-    na_rm,                                                                   \
-    &index,                                                                  \
-    p_out                                                                    \
-  );                                                                         \
+  SEXP out = PROTECT_N(columns_init(x, SEXPTYPE), &n_prot);                  \
+  const R_xlen_t n_columns = columns_n(x);                                   \
+                                                                             \
+  for (R_xlen_t j = 0; j < n_columns; ++j) {                                 \
+    SEXP column = PROTECT(columns_get(x, j));                                \
+                                                                             \
+    /* Before `vec_cast()`, which may drop names */                          \
+    SEXP names = PROTECT(slider_names(column, SLIDE));                       \
+                                                                             \
+    /* No deref, the tree reads ALTREP `column` in chunks */                 \
+    column = PROTECT(vec_cast(column, PTYPE));                               \
+                                                                             \
+    const R_xlen_t size = Rf_xlength(column);                                \
+                                                                             \
+    SEXP out_column = PROTECT(slider_init(SEXPTYPE, size));                  \
+    CTYPE* p_out = DEREF(out_column);                                        \
+    Rf_setAttrib(out_column, R_NamesSymbol, names);                          \
+                                                                             \
+    /* Each column walks the index from the start */                         \
+    struct index_info column_index = index;                                  \
+                                                                             \
+    fn(                                                                      \
+      column,                                                                \
+      size,                                                                  \
+      iter_min,                                                              \
+      iter_max,                                                              \
+      range,                                                                 \
+      p_peer_sizes,                                                          \
+      p_peer_starts,                                                         \
+      p_peer_stops,                                                          \
+      na_rm,                                                                 \
+      &column_index,                                                         \
+      p_out                                                                  \
+    );                                                                       \
+                                                                             \
+    columns_set(x, out, j, out_column);                                      \
+    UNPROTECT(4);                                                            \
+  }                                                                          \
+                                                                             \
+  out = columns_finalize(x, out);                                            \
                                                                              \
   UNPROTECT(n_prot);                                                         \
   return out;                                                                \
@@ -113,7 +151,7 @@ static SEXP slide_index_summary_dbl(SEXP x,
                                     bool complete,
                                     bool na_rm,
                                     summary_index_impl_dbl_fn fn) {
-  SLIDE_INDEX_SUMMARY(slider_shared_empty_dbl, double, REALSXP, REAL_RO, REAL);
+  SLIDE_INDEX_SUMMARY(slider_shared_empty_dbl, double, REALSXP, REAL);
 }
 
 static SEXP slide_index_summary_lgl(SEXP x,
@@ -124,49 +162,368 @@ static SEXP slide_index_summary_lgl(SEXP x,
                                     bool complete,
                                     bool na_rm,
                                     summary_index_impl_lgl_fn fn) {
-  SLIDE_INDEX_SUMMARY(slider_shared_empty_lgl, int, LGLSXP, LOGICAL_RO, LOGICAL);
+  SLIDE_INDEX_SUMMARY(slider_shared_empty_lgl, int, LGLSXP, LOGICAL);
+}
+
+// Logical input, integer output
+static SEXP slide_index_summary_int(SEXP x,
+                                    SEXP i,
+                                    SEXP starts,
+                                    SEXP stops,
+                                    SEXP peer_sizes,
+                                    bool complete,
+                                    bool na_rm,
+                                    summary_index_impl_int_fn fn) {
+  SLIDE_INDEX_SUMMARY(slider_shared_empty_lgl, int, INTSXP, INTEGER);
+}
+
+// Like `slide_index_summary_dbl()`, but bare integer and logical `x` are
+// passed through as is, and `fn` is in charge of aggregating them natively
+static SEXP slide_index_summary_num(SEXP x,
+                                    SEXP i,
+                                    SEXP starts,
+                                    SEXP stops,
+                                    SEXP peer_sizes,
+                                    bool complete,
+                                    bool na_rm,
+                                    summary_index_impl_dbl_fn fn) {
+  SLIDE_INDEX_SUMMARY(summary_leaves_ptype(column), double, REALSXP, REAL);
+}
+
+// Positions of bare integer and logical `x` are located on the values as is
+static SEXP slide_index_summary_position(SEXP x,
+                                         SEXP i,
+                                         SEXP starts,
+                                         SEXP stops,
+                                         SEXP peer_sizes,
+                                         bool complete,
+                                         bool na_rm,
+                                         summary_index_impl_int_fn fn) {
+  SLIDE_INDEX_SUMMARY(summary_leaves_ptype(column), int, INTSXP, INTEGER);
 }
 
 #undef SLIDE_INDEX_SUMMARY
 
+// Counts don't cast `x`, they only need its size and its missing values
+static SEXP slide_index_summary_count(SEXP x,
+                                      SEXP i,
+                                      SEXP starts,
+                                      SEXP stops,
+                                      SEXP peer_sizes,
+                                      bool complete,
+                                      bool na_rm,
+                                      summary_index_impl_int_fn fn) {
+  int n_prot = 0;
+
+  SEXP names = PROTECT_N(slider_names(x, SLIDE), &n_prot);
+
+  const R_xlen_t size = vec_size(x);
+
+  SEXP out = PROTECT_N(slider_init(INTSXP, size), &n_prot);
+  int* p_out = INTEGER(out);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  struct index_info index = new_index_info(i);
+  PROTECT_INDEX_INFO(&index, &n_prot);
+
+  const int* p_peer_sizes = INTEGER_RO(peer_sizes);
+  int* p_peer_starts = (int*) R_alloc(index.size, sizeof(int));
+  int* p_peer_stops = (int*) R_alloc(index.size, sizeof(int));
+  fill_peer_info(p_peer_sizes, index.size, p_peer_starts, p_peer_stops);
+
+  struct range_info range = new_range_info(starts, stops, index.size);
+  PROTECT_RANGE_INFO(&range, &n_prot);
+
+  const int iter_min = compute_min_iteration(index, range, complete);
+  const int iter_max = compute_max_iteration(index, range, complete);
+
+  fn(
+    x,
+    size,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    na_rm,
+    &index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// Like `slide_index_summary_count()`, with a double result
+static SEXP slide_index_summary_count_dbl(SEXP x,
+                                          SEXP i,
+                                          SEXP starts,
+                                          SEXP stops,
+                                          SEXP peer_sizes,
+                                          bool complete,
+                                          bool na_rm,
+                                          summary_index_impl_dbl_fn fn) {
+  int n_prot = 0;
+
+  SEXP names = PROTECT_N(slider_names(x, SLIDE), &n_prot);
+
+  const R_xlen_t size = vec_size(x);
+
+  SEXP out = PROTECT_N(slider_init(REALSXP, size), &n_prot);
+  double* p_out = REAL(out);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  struct index_info index = new_index_info(i);
+  PROTECT_INDEX_INFO(&index, &n_prot);
+
+  const int* p_peer_sizes = INTEGER_RO(peer_sizes);
+  int* p_peer_starts = (int*) R_alloc(index.size, sizeof(int));
+  int* p_peer_stops = (int*) R_alloc(index.size, sizeof(int));
+  fill_peer_info(p_peer_sizes, index.size, p_peer_starts, p_peer_stops);
+
+  struct range_info range = new_range_info(starts, stops, index.size);
+  PROTECT_RANGE_INFO(&range, &n_prot);
+
+  const int iter_min = compute_min_iteration(index, range, complete);
+  const int iter_max = compute_max_iteration(index, range, complete);
+
+  fn(
+    x,
+    size,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    na_rm,
+    &index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// Like counts, `fn` only locates a position of each window. The values of `x`
+// at those positions are sliced out afterwards, so `x` can be any vector.
+static SEXP slide_index_summary_slice(SEXP x,
+                                      SEXP i,
+                                      SEXP starts,
+                                      SEXP stops,
+                                      SEXP peer_sizes,
+                                      bool complete,
+                                      bool na_rm,
+                                      summary_index_impl_int_fn fn) {
+  int n_prot = 0;
+
+  SEXP names = PROTECT_N(slider_names(x, SLIDE), &n_prot);
+
+  const R_xlen_t size = vec_size(x);
+
+  SEXP positions = PROTECT_N(slider_init(INTSXP, size), &n_prot);
+  int* p_positions = INTEGER(positions);
+
+  struct index_info index = new_index_info(i);
+  PROTECT_INDEX_INFO(&index, &n_prot);
+
+  const int* p_peer_sizes = INTEGER_RO(peer_sizes);
+  int* p_peer_starts = (int*) R_alloc(index.size, sizeof(int));
+  int* p_peer_stops = (int*) R_alloc(index.size, sizeof(int));
+  fill_peer_info(p_peer_sizes, index.size, p_peer_starts, p_peer_stops);
+
+  struct range_info range = new_range_info(starts, stops, index.size);
+  PROTECT_RANGE_INFO(&range, &n_prot);
+
+  const int iter_min = compute_min_iteration(index, range, complete);
+  const int iter_max = compute_max_iteration(index, range, complete);
+
+  fn(
+    x,
+    size,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    na_rm,
+    &index,
+    p_positions
+  );
+
+  SEXP out = PROTECT_N(vec_slice_impl(x, positions), &n_prot);
+  out = vec_set_names(out, names);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
 // -----------------------------------------------------------------------------
 
-#define SLIDE_INDEX_SUMMARY_LOOP(CTYPE, INIT) do {                       \
-  for (int i = iter_min; i < iter_max; ++i) {                            \
-    if (i % 1024 == 0) {                                                 \
-      R_CheckUserInterrupt();                                            \
-    }                                                                    \
-                                                                         \
-    int peer_starts_pos = locate_peer_starts_pos(p_index, range, i);     \
-    int peer_stops_pos = locate_peer_stops_pos(p_index, range, i);       \
-                                                                         \
-    int window_start;                                                    \
-    int window_stop;                                                     \
-                                                                         \
-    if (peer_stops_pos < peer_starts_pos) {                              \
-      /* Signal that the window selection was completely OOB */          \
-      window_start = 0;                                                  \
-      window_stop = 0;                                                   \
-    } else {                                                             \
-      window_start = p_peer_starts[peer_starts_pos];                     \
-      window_stop = p_peer_stops[peer_stops_pos] + 1;                    \
-    }                                                                    \
-                                                                         \
-    CTYPE result = INIT;                                                 \
-                                                                         \
-    segment_tree_aggregate(p_tree, window_start, window_stop, &result);  \
-                                                                         \
-    int peer_start = p_peer_starts[i];                                   \
-    int peer_size = p_peer_sizes[i];                                     \
-                                                                         \
-    for (int j = 0; j < peer_size; ++j) {                                \
-      p_out[peer_start] = result;                                        \
-      ++peer_start;                                                      \
-    }                                                                    \
-  }                                                                      \
+// Runs iterations `[BEGIN, END)`, with the peer locators of `p_index` already
+// positioned for `BEGIN`. Runs of peer groups with the same window only
+// `AGGREGATE` the first one, and the queries are counted in `p_counts`, see
+// `query-counts.h`.
+#define SLIDE_INDEX_SUMMARY_LOOP_RANGE(BEGIN, END, INTERRUPTIBLE, CTYPE, INIT, AGGREGATE) do { \
+  int previous_start = -1;                                                                    \
+  int previous_stop = -1;                                                                     \
+  CTYPE previous = INIT;                                                                      \
+                                                                                              \
+  for (int i = BEGIN; i < END; ++i) {                                                         \
+    if (INTERRUPTIBLE && i % 1024 == 0) {                                                     \
+      R_CheckUserInterrupt();                                                                 \
+    }                                                                                         \
+                                                                                              \
+    int peer_starts_pos = locate_peer_starts_pos(p_index, range, i);                          \
+    int peer_stops_pos = locate_peer_stops_pos(p_index, range, i);                            \
+                                                                                              \
+    int window_start;                                                                         \
+    int window_stop;                                                                          \
+                                                                                              \
+    if (peer_stops_pos < peer_starts_pos) {                                                   \
+      /* Signal that the window selection was completely OOB */                               \
+      window_start = 0;                                                                       \
+      window_stop = 0;                                                                        \
+    } else {                                                                                  \
+      window_start = p_peer_starts[peer_starts_pos];                                          \
+      window_stop = p_peer_stops[peer_stops_pos] + 1;                                         \
+    }                                                                                         \
+                                                                                              \
+    CTYPE result = INIT;                                                                      \
+                                                                                              \
+    ++p_counts->n_queries;                                                                    \
+                                                                                              \
+    if (window_start == previous_start && window_stop == previous_stop) {                     \
+      result = previous;                                                                      \
+      ++p_counts->n_reused;                                                                   \
+    } else {                                                                                  \
+      AGGREGATE;                                                                              \
+      previous = result;                                                                      \
+      previous_start = window_start;                                                          \
+      previous_stop = window_stop;                                                            \
+    }                                                                                         \
+                                                                                              \
+    int peer_start = p_peer_starts[i];                                                        \
+    int peer_size = p_peer_sizes[i];                                                          \
+                                                                                              \
+    for (int j = 0; j < peer_size; ++j) {                                                     \
+      p_out[peer_start] = result;                                                             \
+      ++peer_start;                                                                           \
+    }                                                                                         \
+  }                                                                                           \
 } while (0)
 
+#define SLIDE_INDEX_SUMMARY_LOOP(CTYPE, INIT, AGGREGATE) do {                         \
+  struct query_counts counts = new_query_counts();                                    \
+  struct query_counts* p_counts = &counts;                                            \
+                                                                                      \
+  SLIDE_INDEX_SUMMARY_LOOP_RANGE(iter_min, iter_max, true, CTYPE, INIT, AGGREGATE);   \
+                                                                                      \
+  query_counts_record(counts);                                                        \
+} while (0)
+
+
+/*
+ * Windows always start and stop on the boundaries of peer groups, so the
+ * trees are built over the peer groups when they are large, see
+ * `new_segment_tree_runs()`. These trees are queried by peer group.
+ */
+static inline void slide_index_summary_tree_aggregate(const struct segment_tree* p_tree,
+                                                      void* p_state,
+                                                      int peer_starts_pos,
+                                                      int peer_stops_pos,
+                                                      int window_start,
+                                                      int window_stop,
+                                                      double* p_result) {
+  if (!p_tree->runs) {
+    segment_tree_aggregate_state(p_tree, window_start, window_stop, p_state, p_result);
+    return;
+  }
+
+  if (peer_stops_pos < peer_starts_pos) {
+    segment_tree_aggregate_state(p_tree, 0, 0, p_state, p_result);
+    return;
+  }
+
+  segment_tree_aggregate_state(p_tree, peer_starts_pos, peer_stops_pos + 1, p_state, p_result);
+}
+
+static inline void slide_index_summary_loop_dbl_range(const struct segment_tree* p_tree,
+                                                      void* p_state,
+                                                      int begin,
+                                                      int end,
+                                                      bool interruptible,
+                                                      const struct range_info range,
+                                                      const int* p_peer_sizes,
+                                                      const int* p_peer_starts,
+                                                      const int* p_peer_stops,
+                                                      struct index_info* p_index,
+                                                      struct query_counts* p_counts,
+                                                      double* p_out) {
+  SLIDE_INDEX_SUMMARY_LOOP_RANGE(
+    begin,
+    end,
+    interruptible,
+    double,
+    0,
+    slide_index_summary_tree_aggregate(
+      p_tree,
+      p_state,
+      peer_starts_pos,
+      peer_stops_pos,
+      window_start,
+      window_stop,
+      &result
+    )
+  );
+}
+
+struct slide_index_summary_chunks_dbl {
+  const struct segment_tree* p_tree;
+  union segment_tree_state* p_states;
+  struct query_counts* p_counts;
+  int iter_min;
+  const struct range_info* p_range;
+  const int* p_peer_sizes;
+  const int* p_peer_starts;
+  const int* p_peer_stops;
+  const struct index_info* p_index;
+  double* p_out;
+};
+
+static void slide_index_summary_chunk_dbl(void* p_data, int thread, R_xlen_t begin, R_xlen_t end) {
+  const struct slide_index_summary_chunks_dbl* p_chunks = (const struct slide_index_summary_chunks_dbl*) p_data;
+
+  const int iter_begin = p_chunks->iter_min + (int) begin;
+  const int iter_end = p_chunks->iter_min + (int) end;
+
+  // Each chunk has locators of its own, positioned by binary search
+  struct index_info index = *p_chunks->p_index;
+  index_info_seek(&index, *p_chunks->p_range, iter_begin);
+
+  slide_index_summary_loop_dbl_range(
+    p_chunks->p_tree,
+    &p_chunks->p_states[thread],
+    iter_begin,
+    iter_end,
+    false,
+    *p_chunks->p_range,
+    p_chunks->p_peer_sizes,
+    p_chunks->p_peer_starts,
+    p_chunks->p_peer_stops,
+    &index,
+    &p_chunks->p_counts[thread],
+    p_chunks->p_out
+  );
+}
 
+/*
+ * Like `slide_summary_loop_dbl()`, queries are spread over threads with the
+ * `slider.threads` option. The iterations over the unique values of `i` are
+ * split in chunks, whatever the groups when sliding by group.
+ */
 static inline void slide_index_summary_loop_dbl(const struct segment_tree* p_tree,
                                                 int iter_min,
                                                 int iter_max,
@@ -176,24 +533,238 @@ static inline void slide_index_summary_loop_dbl(const struct segment_tree* p_tre
                                                 const int* p_peer_stops,
                                                 struct index_info* p_index,
                                                 double* p_out) {
-  SLIDE_INDEX_SUMMARY_LOOP(double, 0);
+  const R_xlen_t size = max(iter_max - iter_min, 0);
+  const int n_threads = segment_tree_is_concurrent(p_tree) ? parallel_n_threads(size) : 1;
+
+  if (n_threads == 1) {
+    struct query_counts counts = new_query_counts();
+
+    slide_index_summary_loop_dbl_range(
+      p_tree,
+      p_tree->p_state,
+      iter_min,
+      iter_max,
+      true,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      p_index,
+      &counts,
+      p_out
+    );
+
+    query_counts_record(counts);
+    return;
+  }
+
+  struct slide_index_summary_chunks_dbl chunks = {
+    .p_tree = p_tree,
+    .p_states = (union segment_tree_state*) R_alloc(n_threads, sizeof(union segment_tree_state)),
+    .p_counts = (struct query_counts*) R_alloc(n_threads, sizeof(struct query_counts)),
+    .iter_min = iter_min,
+    .p_range = &range,
+    .p_peer_sizes = p_peer_sizes,
+    .p_peer_starts = p_peer_starts,
+    .p_peer_stops = p_peer_stops,
+    .p_index = p_index,
+    .p_out = p_out
+  };
+
+  for (int thread = 0; thread < n_threads; ++thread) {
+    chunks.p_counts[thread] = new_query_counts();
+  }
+
+  parallel_for(size, n_threads, slide_index_summary_chunk_dbl, &chunks);
+
+  for (int thread = 0; thread < n_threads; ++thread) {
+    query_counts_record(chunks.p_counts[thread]);
+  }
 }
 
-static inline void slide_index_summary_loop_lgl(const struct segment_tree* p_tree,
-                                                int iter_min,
-                                                int iter_max,
-                                                const struct range_info range,
-                                                const int* p_peer_sizes,
-                                                const int* p_peer_starts,
-                                                const int* p_peer_stops,
-                                                struct index_info* p_index,
-                                                int* p_out) {
-  SLIDE_INDEX_SUMMARY_LOOP(int, 0);
+static inline void slide_index_summary_loop_bitmap(const struct lgl_bitmap* p_bitmap,
+                                                   int iter_min,
+                                                   int iter_max,
+                                                   const struct range_info range,
+                                                   const int* p_peer_sizes,
+                                                   const int* p_peer_starts,
+                                                   const int* p_peer_stops,
+                                                   struct index_info* p_index,
+                                                   bool na_rm,
+                                                   lgl_bitmap_summary_fn fn,
+                                                   int* p_out) {
+  SLIDE_INDEX_SUMMARY_LOOP(
+    int,
+    0,
+    result = fn(p_bitmap, window_start, window_stop, na_rm)
+  );
+}
+
+// The size of each window comes straight from the peer group boundaries,
+// `x` is never touched
+static inline void slide_index_summary_loop_n(int iter_min,
+                                              int iter_max,
+                                              const struct range_info range,
+                                              const int* p_peer_sizes,
+                                              const int* p_peer_starts,
+                                              const int* p_peer_stops,
+                                              struct index_info* p_index,
+                                              int* p_out) {
+  SLIDE_INDEX_SUMMARY_LOOP(
+    int,
+    0,
+    result = window_stop - window_start
+  );
+}
+
+// Empty windows never reach `fn`, so engines only ever see bounds that move
+// forwards
+static inline void slide_index_summary_loop_position(void* p_engine,
+                                                     window_position_fn fn,
+                                                     int iter_min,
+                                                     int iter_max,
+                                                     const struct range_info range,
+                                                     const int* p_peer_sizes,
+                                                     const int* p_peer_starts,
+                                                     const int* p_peer_stops,
+                                                     struct index_info* p_index,
+                                                     int* p_out) {
+  SLIDE_INDEX_SUMMARY_LOOP(
+    int,
+    NA_INTEGER,
+    if (window_start < window_stop) {
+      result = window_position_as_int(fn(p_engine, window_start, window_stop));
+    }
+  );
+}
+
+static inline void slide_index_summary_loop_n_distinct(struct window_category* p_category,
+                                                      int iter_min,
+                                                      int iter_max,
+                                                      const struct range_info range,
+                                                      const int* p_peer_sizes,
+                                                      const int* p_peer_starts,
+                                                      const int* p_peer_stops,
+                                                      struct index_info* p_index,
+                                                      int* p_out) {
+  SLIDE_INDEX_SUMMARY_LOOP(
+    int,
+    0,
+    if (window_start < window_stop) {
+      result = window_n_distinct(p_category, window_start, window_stop);
+    }
+  );
+}
+
+static inline void slide_index_summary_loop_entropy(struct window_category* p_category,
+                                                    int iter_min,
+                                                    int iter_max,
+                                                    const struct range_info range,
+                                                    const int* p_peer_sizes,
+                                                    const int* p_peer_starts,
+                                                    const int* p_peer_stops,
+                                                    struct index_info* p_index,
+                                                    double* p_out) {
+  SLIDE_INDEX_SUMMARY_LOOP(
+    double,
+    NA_REAL,
+    if (window_start < window_stop) {
+      result = window_entropy(p_category, window_start, window_stop);
+    }
+  );
+}
+
+#undef SLIDE_INDEX_SUMMARY_LOOP
+#undef SLIDE_INDEX_SUMMARY_LOOP_RANGE
+
+// Unlike the other summaries, peers don't share a result. Each of them is
+// ranked within the window of its peer group.
+static inline void slide_index_summary_loop_rank(struct window_rank* p_rank,
+                                                 int iter_min,
+                                                 int iter_max,
+                                                 const struct range_info range,
+                                                 const int* p_peer_sizes,
+                                                 const int* p_peer_starts,
+                                                 const int* p_peer_stops,
+                                                 struct index_info* p_index,
+                                                 double* p_out) {
+  for (int i = iter_min; i < iter_max; ++i) {
+    if (i % 1024 == 0) {
+      R_CheckUserInterrupt();
+    }
+
+    int peer_starts_pos = locate_peer_starts_pos(p_index, range, i);
+    int peer_stops_pos = locate_peer_stops_pos(p_index, range, i);
+
+    int window_start;
+    int window_stop;
+
+    if (peer_stops_pos < peer_starts_pos) {
+      window_start = 0;
+      window_stop = 0;
+    } else {
+      window_start = p_peer_starts[peer_starts_pos];
+      window_stop = p_peer_stops[peer_stops_pos] + 1;
+    }
+
+    const int peer_start = p_peer_starts[i];
+    const int peer_stop = peer_start + p_peer_sizes[i];
+
+    for (int j = peer_start; j < peer_stop; ++j) {
+      p_out[j] = window_rank_locate(p_rank, window_start, window_stop, j);
+    }
+  }
 }
 
 // -----------------------------------------------------------------------------
 
-static void slider_index_sum_core_impl(const double* p_x,
+static void slider_index_sum_int_core_impl(SEXP x,
+                                           R_xlen_t size,
+                                           int iter_min,
+                                           int iter_max,
+                                           const struct range_info range,
+                                           const int* p_peer_sizes,
+                                           const int* p_peer_starts,
+                                           const int* p_peer_stops,
+                                           bool na_rm,
+                                           struct index_info* p_index,
+                                           double* p_out) {
+  int n_prot = 0;
+
+  int64_t state = 0;
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    sum_int_state_reset,
+    sum_int_state_finalize,
+    sum_int_nodes_increment,
+    sum_int_nodes_initialize,
+    sum_int_nodes_void_deref,
+    na_rm ? sum_int_na_rm_aggregate_from_leaves : sum_int_na_keep_aggregate_from_leaves,
+    na_rm ? sum_int_na_rm_aggregate_from_nodes : sum_int_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static void slider_index_sum_core_impl(SEXP x,
                                        R_xlen_t size,
                                        int iter_min,
                                        int iter_max,
@@ -204,13 +775,32 @@ static void slider_index_sum_core_impl(const double* p_x,
                                        bool na_rm,
                                        struct index_info* p_index,
                                        double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slider_index_sum_int_core_impl(
+      x,
+      size,
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      na_rm,
+      p_index,
+      p_out
+    );
+    return;
+  }
+
   int n_prot = 0;
 
   long double state = 0;
 
-  struct segment_tree tree = new_segment_tree(
+  struct segment_tree tree = new_segment_tree_runs(
     size,
-    p_x,
+    x,
+    p_index->size,
+    p_peer_sizes,
     &state,
     sum_state_reset,
     sum_state_finalize,
@@ -244,7 +834,7 @@ static SEXP slide_index_sum_core(SEXP x,
                                  SEXP peer_sizes,
                                  bool complete,
                                  bool na_rm) {
-  return slide_index_summary_dbl(
+  return slide_index_summary_num(
     x,
     i,
     starts,
@@ -278,7 +868,7 @@ SEXP slider_index_sum_core(SEXP x,
 
 // -----------------------------------------------------------------------------
 
-static void slider_index_prod_core_impl(const double* p_x,
+static void slider_index_prod_core_impl(SEXP x,
                                         R_xlen_t size,
                                         int iter_min,
                                         int iter_max,
@@ -293,9 +883,11 @@ static void slider_index_prod_core_impl(const double* p_x,
 
   long double state = 1;
 
-  struct segment_tree tree = new_segment_tree(
+  struct segment_tree tree = new_segment_tree_runs(
     size,
-    p_x,
+    x,
+    p_index->size,
+    p_peer_sizes,
     &state,
     prod_state_reset,
     prod_state_finalize,
@@ -363,32 +955,35 @@ SEXP slider_index_prod_core(SEXP x,
 
 // -----------------------------------------------------------------------------
 
-static void slider_index_mean_core_impl(const double* p_x,
-                                        R_xlen_t size,
-                                        int iter_min,
-                                        int iter_max,
-                                        const struct range_info range,
-                                        const int* p_peer_sizes,
-                                        const int* p_peer_starts,
-                                        const int* p_peer_stops,
-                                        bool na_rm,
-                                        struct index_info* p_index,
-                                        double* p_out) {
+static void slider_index_log_prod_core_impl(SEXP x,
+                                            R_xlen_t size,
+                                            int iter_min,
+                                            int iter_max,
+                                            const struct range_info range,
+                                            const int* p_peer_sizes,
+                                            const int* p_peer_starts,
+                                            const int* p_peer_stops,
+                                            bool na_rm,
+                                            struct index_info* p_index,
+                                            double* p_out) {
   int n_prot = 0;
 
-  struct mean_state_t state = { .sum = 0, .count = 0 };
+  struct log_prod_state_t state;
+  log_prod_state_reset(&state);
 
-  struct segment_tree tree = new_segment_tree(
+  struct segment_tree tree = new_segment_tree_runs(
     size,
-    p_x,
+    x,
+    p_index->size,
+    p_peer_sizes,
     &state,
-    mean_state_reset,
-    mean_state_finalize,
-    mean_nodes_increment,
-    mean_nodes_initialize,
-    mean_nodes_void_deref,
-    na_rm ? mean_na_rm_aggregate_from_leaves : mean_na_keep_aggregate_from_leaves,
-    na_rm ? mean_na_rm_aggregate_from_nodes : mean_na_keep_aggregate_from_nodes
+    log_prod_state_reset,
+    log_prod_state_finalize,
+    log_prod_nodes_increment,
+    log_prod_nodes_initialize,
+    log_prod_nodes_void_deref,
+    na_rm ? log_prod_na_rm_aggregate_from_leaves : log_prod_na_keep_aggregate_from_leaves,
+    na_rm ? log_prod_na_rm_aggregate_from_nodes : log_prod_na_keep_aggregate_from_nodes
   );
   PROTECT_SEGMENT_TREE(&tree, &n_prot);
 
@@ -407,13 +1002,13 @@ static void slider_index_mean_core_impl(const double* p_x,
   UNPROTECT(n_prot);
 }
 
-static SEXP slide_index_mean_core(SEXP x,
-                                  SEXP i,
-                                  SEXP starts,
-                                  SEXP stops,
-                                  SEXP peer_sizes,
-                                  bool complete,
-                                  bool na_rm) {
+static SEXP slide_index_log_prod_core(SEXP x,
+                                      SEXP i,
+                                      SEXP starts,
+                                      SEXP stops,
+                                      SEXP peer_sizes,
+                                      bool complete,
+                                      bool na_rm) {
   return slide_index_summary_dbl(
     x,
     i,
@@ -422,18 +1017,18 @@ static SEXP slide_index_mean_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slider_index_mean_core_impl
+    slider_index_log_prod_core_impl
   );
 }
 
 // [[ register() ]]
-SEXP slider_index_mean_core(SEXP x,
-                            SEXP i,
-                            SEXP starts,
-                            SEXP stops,
-                            SEXP peer_sizes,
-                            SEXP complete,
-                            SEXP na_rm) {
+SEXP slider_index_log_prod_core(SEXP x,
+                                SEXP i,
+                                SEXP starts,
+                                SEXP stops,
+                                SEXP peer_sizes,
+                                SEXP complete,
+                                SEXP na_rm) {
   return slider_index_summary(
     x,
     i,
@@ -442,38 +1037,41 @@ SEXP slider_index_mean_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slide_index_mean_core
+    slide_index_log_prod_core
   );
 }
 
 // -----------------------------------------------------------------------------
 
-static void slider_index_min_core_impl(const double* p_x,
-                                       R_xlen_t size,
-                                       int iter_min,
-                                       int iter_max,
-                                       const struct range_info range,
-                                       const int* p_peer_sizes,
-                                       const int* p_peer_starts,
-                                       const int* p_peer_stops,
-                                       bool na_rm,
-                                       struct index_info* p_index,
-                                       double* p_out) {
+static void slider_index_geomean_core_impl(SEXP x,
+                                           R_xlen_t size,
+                                           int iter_min,
+                                           int iter_max,
+                                           const struct range_info range,
+                                           const int* p_peer_sizes,
+                                           const int* p_peer_starts,
+                                           const int* p_peer_stops,
+                                           bool na_rm,
+                                           struct index_info* p_index,
+                                           double* p_out) {
   int n_prot = 0;
 
-  long double state = 1;
+  struct log_prod_state_t state;
+  log_prod_state_reset(&state);
 
-  struct segment_tree tree = new_segment_tree(
+  struct segment_tree tree = new_segment_tree_runs(
     size,
-    p_x,
+    x,
+    p_index->size,
+    p_peer_sizes,
     &state,
-    min_state_reset,
-    min_state_finalize,
-    min_nodes_increment,
-    min_nodes_initialize,
-    min_nodes_void_deref,
-    na_rm ? min_na_rm_aggregate_from_leaves : min_na_keep_aggregate_from_leaves,
-    na_rm ? min_na_rm_aggregate_from_nodes : min_na_keep_aggregate_from_nodes
+    log_prod_state_reset,
+    geomean_state_finalize,
+    log_prod_nodes_increment,
+    log_prod_nodes_initialize,
+    log_prod_nodes_void_deref,
+    na_rm ? log_prod_na_rm_aggregate_from_leaves : log_prod_na_keep_aggregate_from_leaves,
+    na_rm ? log_prod_na_rm_aggregate_from_nodes : log_prod_na_keep_aggregate_from_nodes
   );
   PROTECT_SEGMENT_TREE(&tree, &n_prot);
 
@@ -492,13 +1090,13 @@ static void slider_index_min_core_impl(const double* p_x,
   UNPROTECT(n_prot);
 }
 
-static SEXP slide_index_min_core(SEXP x,
-                                 SEXP i,
-                                 SEXP starts,
-                                 SEXP stops,
-                                 SEXP peer_sizes,
-                                 bool complete,
-                                 bool na_rm) {
+static SEXP slide_index_geomean_core(SEXP x,
+                                     SEXP i,
+                                     SEXP starts,
+                                     SEXP stops,
+                                     SEXP peer_sizes,
+                                     bool complete,
+                                     bool na_rm) {
   return slide_index_summary_dbl(
     x,
     i,
@@ -507,18 +1105,18 @@ static SEXP slide_index_min_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slider_index_min_core_impl
+    slider_index_geomean_core_impl
   );
 }
 
 // [[ register() ]]
-SEXP slider_index_min_core(SEXP x,
-                           SEXP i,
-                           SEXP starts,
-                           SEXP stops,
-                           SEXP peer_sizes,
-                           SEXP complete,
-                           SEXP na_rm) {
+SEXP slider_index_geomean_core(SEXP x,
+                               SEXP i,
+                               SEXP starts,
+                               SEXP stops,
+                               SEXP peer_sizes,
+                               SEXP complete,
+                               SEXP na_rm) {
   return slider_index_summary(
     x,
     i,
@@ -527,38 +1125,40 @@ SEXP slider_index_min_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slide_index_min_core
+    slide_index_geomean_core
   );
 }
 
 // -----------------------------------------------------------------------------
 
-static void slider_index_max_core_impl(const double* p_x,
-                                       R_xlen_t size,
-                                       int iter_min,
-                                       int iter_max,
-                                       const struct range_info range,
-                                       const int* p_peer_sizes,
-                                       const int* p_peer_starts,
-                                       const int* p_peer_stops,
-                                       bool na_rm,
-                                       struct index_info* p_index,
-                                       double* p_out) {
+static void slider_index_mean_int_core_impl(SEXP x,
+                                            R_xlen_t size,
+                                            int iter_min,
+                                            int iter_max,
+                                            const struct range_info range,
+                                            const int* p_peer_sizes,
+                                            const int* p_peer_starts,
+                                            const int* p_peer_stops,
+                                            bool na_rm,
+                                            struct index_info* p_index,
+                                            double* p_out) {
   int n_prot = 0;
 
-  long double state = 1;
+  struct mean_int_state_t state = { .sum = 0, .count = 0 };
 
-  struct segment_tree tree = new_segment_tree(
+  struct segment_tree tree = new_segment_tree_runs(
     size,
-    p_x,
+    x,
+    p_index->size,
+    p_peer_sizes,
     &state,
-    max_state_reset,
-    max_state_finalize,
-    max_nodes_increment,
-    max_nodes_initialize,
-    max_nodes_void_deref,
-    na_rm ? max_na_rm_aggregate_from_leaves : max_na_keep_aggregate_from_leaves,
-    na_rm ? max_na_rm_aggregate_from_nodes : max_na_keep_aggregate_from_nodes
+    mean_int_state_reset,
+    mean_int_state_finalize,
+    mean_int_nodes_increment,
+    mean_int_nodes_initialize,
+    mean_int_nodes_void_deref,
+    na_rm ? mean_int_na_rm_aggregate_from_leaves : mean_int_na_keep_aggregate_from_leaves,
+    na_rm ? mean_int_na_rm_aggregate_from_nodes : mean_int_na_keep_aggregate_from_nodes
   );
   PROTECT_SEGMENT_TREE(&tree, &n_prot);
 
@@ -577,14 +1177,77 @@ static void slider_index_max_core_impl(const double* p_x,
   UNPROTECT(n_prot);
 }
 
-static SEXP slide_index_max_core(SEXP x,
-                                 SEXP i,
-                                 SEXP starts,
-                                 SEXP stops,
-                                 SEXP peer_sizes,
-                                 bool complete,
-                                 bool na_rm) {
-  return slide_index_summary_dbl(
+static void slider_index_mean_core_impl(SEXP x,
+                                        R_xlen_t size,
+                                        int iter_min,
+                                        int iter_max,
+                                        const struct range_info range,
+                                        const int* p_peer_sizes,
+                                        const int* p_peer_starts,
+                                        const int* p_peer_stops,
+                                        bool na_rm,
+                                        struct index_info* p_index,
+                                        double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slider_index_mean_int_core_impl(
+      x,
+      size,
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      na_rm,
+      p_index,
+      p_out
+    );
+    return;
+  }
+
+  int n_prot = 0;
+
+  struct mean_state_t state = { .sum = 0, .count = 0 };
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    mean_state_reset,
+    mean_state_finalize,
+    mean_nodes_increment,
+    mean_nodes_initialize,
+    mean_nodes_void_deref,
+    na_rm ? mean_na_rm_aggregate_from_leaves : mean_na_keep_aggregate_from_leaves,
+    na_rm ? mean_na_rm_aggregate_from_nodes : mean_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_mean_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  bool complete,
+                                  bool na_rm) {
+  return slide_index_summary_num(
     x,
     i,
     starts,
@@ -592,18 +1255,18 @@ static SEXP slide_index_max_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slider_index_max_core_impl
+    slider_index_mean_core_impl
   );
 }
 
 // [[ register() ]]
-SEXP slider_index_max_core(SEXP x,
-                           SEXP i,
-                           SEXP starts,
-                           SEXP stops,
-                           SEXP peer_sizes,
-                           SEXP complete,
-                           SEXP na_rm) {
+SEXP slider_index_mean_core(SEXP x,
+                            SEXP i,
+                            SEXP starts,
+                            SEXP stops,
+                            SEXP peer_sizes,
+                            SEXP complete,
+                            SEXP na_rm) {
   return slider_index_summary(
     x,
     i,
@@ -612,42 +1275,45 @@ SEXP slider_index_max_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slide_index_max_core
+    slide_index_mean_core
   );
 }
 
 // -----------------------------------------------------------------------------
 
-static void slider_index_all_core_impl(const int* p_x,
-                                       R_xlen_t size,
-                                       int iter_min,
-                                       int iter_max,
-                                       const struct range_info range,
-                                       const int* p_peer_sizes,
-                                       const int* p_peer_starts,
-                                       const int* p_peer_stops,
-                                       bool na_rm,
-                                       struct index_info* p_index,
-                                       int* p_out) {
+static void slider_index_skew_core_impl(SEXP x,
+                                        R_xlen_t size,
+                                        int iter_min,
+                                        int iter_max,
+                                        const struct range_info range,
+                                        const int* p_peer_sizes,
+                                        const int* p_peer_starts,
+                                        const int* p_peer_stops,
+                                        bool na_rm,
+                                        struct index_info* p_index,
+                                        double* p_out) {
   int n_prot = 0;
 
-  int state = 1;
+  struct moment_state_t state;
+  moment_state_reset(&state);
 
-  struct segment_tree tree = new_segment_tree(
+  struct segment_tree tree = new_segment_tree_runs(
     size,
-    p_x,
+    x,
+    p_index->size,
+    p_peer_sizes,
     &state,
-    all_state_reset,
-    all_state_finalize,
-    all_nodes_increment,
-    all_nodes_initialize,
-    all_nodes_void_deref,
-    na_rm ? all_na_rm_aggregate_from_leaves : all_na_keep_aggregate_from_leaves,
-    na_rm ? all_na_rm_aggregate_from_nodes : all_na_keep_aggregate_from_nodes
+    moment_state_reset,
+    skew_state_finalize,
+    moment_nodes_increment,
+    moment_nodes_initialize,
+    moment_nodes_void_deref,
+    na_rm ? moment_na_rm_aggregate_from_leaves : moment_na_keep_aggregate_from_leaves,
+    na_rm ? moment_na_rm_aggregate_from_nodes : moment_na_keep_aggregate_from_nodes
   );
   PROTECT_SEGMENT_TREE(&tree, &n_prot);
 
-  slide_index_summary_loop_lgl(
+  slide_index_summary_loop_dbl(
     &tree,
     iter_min,
     iter_max,
@@ -662,14 +1328,14 @@ static void slider_index_all_core_impl(const int* p_x,
   UNPROTECT(n_prot);
 }
 
-static SEXP slide_index_all_core(SEXP x,
-                                 SEXP i,
-                                 SEXP starts,
-                                 SEXP stops,
-                                 SEXP peer_sizes,
-                                 bool complete,
-                                 bool na_rm) {
-  return slide_index_summary_lgl(
+static SEXP slide_index_skew_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  bool complete,
+                                  bool na_rm) {
+  return slide_index_summary_dbl(
     x,
     i,
     starts,
@@ -677,18 +1343,18 @@ static SEXP slide_index_all_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slider_index_all_core_impl
+    slider_index_skew_core_impl
   );
 }
 
 // [[ register() ]]
-SEXP slider_index_all_core(SEXP x,
-                           SEXP i,
-                           SEXP starts,
-                           SEXP stops,
-                           SEXP peer_sizes,
-                           SEXP complete,
-                           SEXP na_rm) {
+SEXP slider_index_skew_core(SEXP x,
+                            SEXP i,
+                            SEXP starts,
+                            SEXP stops,
+                            SEXP peer_sizes,
+                            SEXP complete,
+                            SEXP na_rm) {
   return slider_index_summary(
     x,
     i,
@@ -697,42 +1363,45 @@ SEXP slider_index_all_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slide_index_all_core
+    slide_index_skew_core
   );
 }
 
 // -----------------------------------------------------------------------------
 
-static void slider_index_any_core_impl(const int* p_x,
-                                       R_xlen_t size,
-                                       int iter_min,
-                                       int iter_max,
-                                       const struct range_info range,
-                                       const int* p_peer_sizes,
-                                       const int* p_peer_starts,
-                                       const int* p_peer_stops,
-                                       bool na_rm,
-                                       struct index_info* p_index,
-                                       int* p_out) {
+static void slider_index_kurt_core_impl(SEXP x,
+                                        R_xlen_t size,
+                                        int iter_min,
+                                        int iter_max,
+                                        const struct range_info range,
+                                        const int* p_peer_sizes,
+                                        const int* p_peer_starts,
+                                        const int* p_peer_stops,
+                                        bool na_rm,
+                                        struct index_info* p_index,
+                                        double* p_out) {
   int n_prot = 0;
 
-  int state = 0;
+  struct moment_state_t state;
+  moment_state_reset(&state);
 
-  struct segment_tree tree = new_segment_tree(
+  struct segment_tree tree = new_segment_tree_runs(
     size,
-    p_x,
+    x,
+    p_index->size,
+    p_peer_sizes,
     &state,
-    any_state_reset,
-    any_state_finalize,
-    any_nodes_increment,
-    any_nodes_initialize,
-    any_nodes_void_deref,
-    na_rm ? any_na_rm_aggregate_from_leaves : any_na_keep_aggregate_from_leaves,
-    na_rm ? any_na_rm_aggregate_from_nodes : any_na_keep_aggregate_from_nodes
+    moment_state_reset,
+    kurt_state_finalize,
+    moment_nodes_increment,
+    moment_nodes_initialize,
+    moment_nodes_void_deref,
+    na_rm ? moment_na_rm_aggregate_from_leaves : moment_na_keep_aggregate_from_leaves,
+    na_rm ? moment_na_rm_aggregate_from_nodes : moment_na_keep_aggregate_from_nodes
   );
   PROTECT_SEGMENT_TREE(&tree, &n_prot);
 
-  slide_index_summary_loop_lgl(
+  slide_index_summary_loop_dbl(
     &tree,
     iter_min,
     iter_max,
@@ -747,14 +1416,14 @@ static void slider_index_any_core_impl(const int* p_x,
   UNPROTECT(n_prot);
 }
 
-static SEXP slide_index_any_core(SEXP x,
-                                 SEXP i,
-                                 SEXP starts,
-                                 SEXP stops,
-                                 SEXP peer_sizes,
-                                 bool complete,
-                                 bool na_rm) {
-  return slide_index_summary_lgl(
+static SEXP slide_index_kurt_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  bool complete,
+                                  bool na_rm) {
+  return slide_index_summary_dbl(
     x,
     i,
     starts,
@@ -762,18 +1431,18 @@ static SEXP slide_index_any_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slider_index_any_core_impl
+    slider_index_kurt_core_impl
   );
 }
 
 // [[ register() ]]
-SEXP slider_index_any_core(SEXP x,
-                           SEXP i,
-                           SEXP starts,
-                           SEXP stops,
-                           SEXP peer_sizes,
-                           SEXP complete,
-                           SEXP na_rm) {
+SEXP slider_index_kurt_core(SEXP x,
+                            SEXP i,
+                            SEXP starts,
+                            SEXP stops,
+                            SEXP peer_sizes,
+                            SEXP complete,
+                            SEXP na_rm) {
   return slider_index_summary(
     x,
     i,
@@ -782,6 +1451,1483 @@ SEXP slider_index_any_core(SEXP x,
     peer_sizes,
     complete,
     na_rm,
-    slide_index_any_core
+    slide_index_kurt_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_min_int_core_impl(SEXP x,
+                                           R_xlen_t size,
+                                           int iter_min,
+                                           int iter_max,
+                                           const struct range_info range,
+                                           const int* p_peer_sizes,
+                                           const int* p_peer_starts,
+                                           const int* p_peer_stops,
+                                           bool na_rm,
+                                           struct index_info* p_index,
+                                           double* p_out) {
+  int n_prot = 0;
+
+  long double state = 1;
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    min_state_reset,
+    min_state_finalize,
+    min_nodes_increment,
+    min_nodes_initialize,
+    min_nodes_void_deref,
+    na_rm ? min_int_na_rm_aggregate_from_leaves : min_int_na_keep_aggregate_from_leaves,
+    na_rm ? min_na_rm_aggregate_from_nodes : min_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static void slider_index_min_core_impl(SEXP x,
+                                       R_xlen_t size,
+                                       int iter_min,
+                                       int iter_max,
+                                       const struct range_info range,
+                                       const int* p_peer_sizes,
+                                       const int* p_peer_starts,
+                                       const int* p_peer_stops,
+                                       bool na_rm,
+                                       struct index_info* p_index,
+                                       double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slider_index_min_int_core_impl(
+      x,
+      size,
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      na_rm,
+      p_index,
+      p_out
+    );
+    return;
+  }
+
+  int n_prot = 0;
+
+  long double state = 1;
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    min_state_reset,
+    min_state_finalize,
+    min_nodes_increment,
+    min_nodes_initialize,
+    min_nodes_void_deref,
+    na_rm ? min_na_rm_aggregate_from_leaves : min_na_keep_aggregate_from_leaves,
+    na_rm ? min_na_rm_aggregate_from_nodes : min_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_min_core(SEXP x,
+                                 SEXP i,
+                                 SEXP starts,
+                                 SEXP stops,
+                                 SEXP peer_sizes,
+                                 bool complete,
+                                 bool na_rm) {
+  return slide_index_summary_num(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_min_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_min_core(SEXP x,
+                           SEXP i,
+                           SEXP starts,
+                           SEXP stops,
+                           SEXP peer_sizes,
+                           SEXP complete,
+                           SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_min_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_max_int_core_impl(SEXP x,
+                                           R_xlen_t size,
+                                           int iter_min,
+                                           int iter_max,
+                                           const struct range_info range,
+                                           const int* p_peer_sizes,
+                                           const int* p_peer_starts,
+                                           const int* p_peer_stops,
+                                           bool na_rm,
+                                           struct index_info* p_index,
+                                           double* p_out) {
+  int n_prot = 0;
+
+  long double state = 1;
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    max_state_reset,
+    max_state_finalize,
+    max_nodes_increment,
+    max_nodes_initialize,
+    max_nodes_void_deref,
+    na_rm ? max_int_na_rm_aggregate_from_leaves : max_int_na_keep_aggregate_from_leaves,
+    na_rm ? max_na_rm_aggregate_from_nodes : max_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static void slider_index_max_core_impl(SEXP x,
+                                       R_xlen_t size,
+                                       int iter_min,
+                                       int iter_max,
+                                       const struct range_info range,
+                                       const int* p_peer_sizes,
+                                       const int* p_peer_starts,
+                                       const int* p_peer_stops,
+                                       bool na_rm,
+                                       struct index_info* p_index,
+                                       double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slider_index_max_int_core_impl(
+      x,
+      size,
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      na_rm,
+      p_index,
+      p_out
+    );
+    return;
+  }
+
+  int n_prot = 0;
+
+  long double state = 1;
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    max_state_reset,
+    max_state_finalize,
+    max_nodes_increment,
+    max_nodes_initialize,
+    max_nodes_void_deref,
+    na_rm ? max_na_rm_aggregate_from_leaves : max_na_keep_aggregate_from_leaves,
+    na_rm ? max_na_rm_aggregate_from_nodes : max_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_max_core(SEXP x,
+                                 SEXP i,
+                                 SEXP starts,
+                                 SEXP stops,
+                                 SEXP peer_sizes,
+                                 bool complete,
+                                 bool na_rm) {
+  return slide_index_summary_num(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_max_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_max_core(SEXP x,
+                           SEXP i,
+                           SEXP starts,
+                           SEXP stops,
+                           SEXP peer_sizes,
+                           SEXP complete,
+                           SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_max_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_max_drawdown_core_impl(SEXP x,
+                                                R_xlen_t size,
+                                                int iter_min,
+                                                int iter_max,
+                                                const struct range_info range,
+                                                const int* p_peer_sizes,
+                                                const int* p_peer_starts,
+                                                const int* p_peer_stops,
+                                                bool na_rm,
+                                                struct index_info* p_index,
+                                                double* p_out) {
+  int n_prot = 0;
+
+  struct drawdown_state_t state;
+  drawdown_state_reset(&state);
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    drawdown_state_reset,
+    drawdown_state_finalize,
+    drawdown_nodes_increment,
+    drawdown_nodes_initialize,
+    drawdown_nodes_void_deref,
+    na_rm ? drawdown_na_rm_aggregate_from_leaves : drawdown_na_keep_aggregate_from_leaves,
+    na_rm ? drawdown_na_rm_aggregate_from_nodes : drawdown_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_max_drawdown_core(SEXP x,
+                                          SEXP i,
+                                          SEXP starts,
+                                          SEXP stops,
+                                          SEXP peer_sizes,
+                                          bool complete,
+                                          bool na_rm) {
+  return slide_index_summary_dbl(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_max_drawdown_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_max_drawdown_core(SEXP x,
+                                    SEXP i,
+                                    SEXP starts,
+                                    SEXP stops,
+                                    SEXP peer_sizes,
+                                    SEXP complete,
+                                    SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_max_drawdown_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_range_core_impl(SEXP x,
+                                         R_xlen_t size,
+                                         int iter_min,
+                                         int iter_max,
+                                         const struct range_info range,
+                                         const int* p_peer_sizes,
+                                         const int* p_peer_starts,
+                                         const int* p_peer_stops,
+                                         bool na_rm,
+                                         struct index_info* p_index,
+                                         double* p_out) {
+  int n_prot = 0;
+
+  struct drawdown_state_t state;
+  drawdown_state_reset(&state);
+
+  struct segment_tree tree = new_segment_tree_runs(
+    size,
+    x,
+    p_index->size,
+    p_peer_sizes,
+    &state,
+    drawdown_state_reset,
+    range_state_finalize,
+    drawdown_nodes_increment,
+    drawdown_nodes_initialize,
+    drawdown_nodes_void_deref,
+    na_rm ? drawdown_na_rm_aggregate_from_leaves : drawdown_na_keep_aggregate_from_leaves,
+    na_rm ? drawdown_na_rm_aggregate_from_nodes : drawdown_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_index_summary_loop_dbl(
+    &tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_range_core(SEXP x,
+                                   SEXP i,
+                                   SEXP starts,
+                                   SEXP stops,
+                                   SEXP peer_sizes,
+                                   bool complete,
+                                   bool na_rm) {
+  return slide_index_summary_dbl(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_range_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_range_core(SEXP x,
+                             SEXP i,
+                             SEXP starts,
+                             SEXP stops,
+                             SEXP peer_sizes,
+                             SEXP complete,
+                             SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_range_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_all_core_impl(SEXP x,
+                                       R_xlen_t size,
+                                       int iter_min,
+                                       int iter_max,
+                                       const struct range_info range,
+                                       const int* p_peer_sizes,
+                                       const int* p_peer_starts,
+                                       const int* p_peer_stops,
+                                       bool na_rm,
+                                       struct index_info* p_index,
+                                       int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_lgl_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_index_summary_loop_bitmap(
+    &bitmap,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    na_rm,
+    lgl_bitmap_all,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_all_core(SEXP x,
+                                 SEXP i,
+                                 SEXP starts,
+                                 SEXP stops,
+                                 SEXP peer_sizes,
+                                 bool complete,
+                                 bool na_rm) {
+  return slide_index_summary_lgl(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_all_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_all_core(SEXP x,
+                           SEXP i,
+                           SEXP starts,
+                           SEXP stops,
+                           SEXP peer_sizes,
+                           SEXP complete,
+                           SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_all_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_any_core_impl(SEXP x,
+                                       R_xlen_t size,
+                                       int iter_min,
+                                       int iter_max,
+                                       const struct range_info range,
+                                       const int* p_peer_sizes,
+                                       const int* p_peer_starts,
+                                       const int* p_peer_stops,
+                                       bool na_rm,
+                                       struct index_info* p_index,
+                                       int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_lgl_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_index_summary_loop_bitmap(
+    &bitmap,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    na_rm,
+    lgl_bitmap_any,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_any_core(SEXP x,
+                                 SEXP i,
+                                 SEXP starts,
+                                 SEXP stops,
+                                 SEXP peer_sizes,
+                                 bool complete,
+                                 bool na_rm) {
+  return slide_index_summary_lgl(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_any_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_any_core(SEXP x,
+                           SEXP i,
+                           SEXP starts,
+                           SEXP stops,
+                           SEXP peer_sizes,
+                           SEXP complete,
+                           SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_any_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_count_true_core_impl(SEXP x,
+                                              R_xlen_t size,
+                                              int iter_min,
+                                              int iter_max,
+                                              const struct range_info range,
+                                              const int* p_peer_sizes,
+                                              const int* p_peer_starts,
+                                              const int* p_peer_stops,
+                                              bool na_rm,
+                                              struct index_info* p_index,
+                                              int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_lgl_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_index_summary_loop_bitmap(
+    &bitmap,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    na_rm,
+    lgl_bitmap_count,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_count_true_core(SEXP x,
+                                        SEXP i,
+                                        SEXP starts,
+                                        SEXP stops,
+                                        SEXP peer_sizes,
+                                        bool complete,
+                                        bool na_rm) {
+  return slide_index_summary_int(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_count_true_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_count_true_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  SEXP complete,
+                                  SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_count_true_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_n_core_impl(SEXP x,
+                                     R_xlen_t size,
+                                     int iter_min,
+                                     int iter_max,
+                                     const struct range_info range,
+                                     const int* p_peer_sizes,
+                                     const int* p_peer_starts,
+                                     const int* p_peer_stops,
+                                     bool na_rm,
+                                     struct index_info* p_index,
+                                     int* p_out) {
+  if (!na_rm) {
+    slide_index_summary_loop_n(
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      p_index,
+      p_out
+    );
+    return;
+  }
+
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_index_summary_loop_bitmap(
+    &bitmap,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    na_rm,
+    lgl_bitmap_n_complete,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_n_core(SEXP x,
+                               SEXP i,
+                               SEXP starts,
+                               SEXP stops,
+                               SEXP peer_sizes,
+                               bool complete,
+                               bool na_rm) {
+  return slide_index_summary_count(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_n_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_n_core(SEXP x,
+                         SEXP i,
+                         SEXP starts,
+                         SEXP stops,
+                         SEXP peer_sizes,
+                         SEXP complete,
+                         SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_n_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_n_na_core_impl(SEXP x,
+                                        R_xlen_t size,
+                                        int iter_min,
+                                        int iter_max,
+                                        const struct range_info range,
+                                        const int* p_peer_sizes,
+                                        const int* p_peer_starts,
+                                        const int* p_peer_stops,
+                                        bool na_rm,
+                                        struct index_info* p_index,
+                                        int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_index_summary_loop_bitmap(
+    &bitmap,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    na_rm,
+    lgl_bitmap_n_missing,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_n_na_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  bool complete,
+                                  bool na_rm) {
+  return slide_index_summary_count(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_n_na_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_n_na_core(SEXP x,
+                            SEXP i,
+                            SEXP starts,
+                            SEXP stops,
+                            SEXP peer_sizes,
+                            SEXP complete,
+                            SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_n_na_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_first_core_impl(SEXP x,
+                                         R_xlen_t size,
+                                         int iter_min,
+                                         int iter_max,
+                                         const struct range_info range,
+                                         const int* p_peer_sizes,
+                                         const int* p_peer_starts,
+                                         const int* p_peer_stops,
+                                         bool na_rm,
+                                         struct index_info* p_index,
+                                         int* p_out) {
+  if (!na_rm) {
+    slide_index_summary_loop_position(
+      NULL,
+      window_first,
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      p_index,
+      p_out
+    );
+    return;
+  }
+
+  int n_prot = 0;
+
+  struct lgl_bitmap missing = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&missing, &n_prot);
+
+  struct first_complete_cursor cursor = new_first_complete_cursor(&missing);
+
+  slide_index_summary_loop_position(
+    &cursor,
+    window_first_complete,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_first_core(SEXP x,
+                                   SEXP i,
+                                   SEXP starts,
+                                   SEXP stops,
+                                   SEXP peer_sizes,
+                                   bool complete,
+                                   bool na_rm) {
+  return slide_index_summary_slice(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_first_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_first_core(SEXP x,
+                             SEXP i,
+                             SEXP starts,
+                             SEXP stops,
+                             SEXP peer_sizes,
+                             SEXP complete,
+                             SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_first_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_last_core_impl(SEXP x,
+                                        R_xlen_t size,
+                                        int iter_min,
+                                        int iter_max,
+                                        const struct range_info range,
+                                        const int* p_peer_sizes,
+                                        const int* p_peer_starts,
+                                        const int* p_peer_stops,
+                                        bool na_rm,
+                                        struct index_info* p_index,
+                                        int* p_out) {
+  if (!na_rm) {
+    slide_index_summary_loop_position(
+      NULL,
+      window_last,
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      p_index,
+      p_out
+    );
+    return;
+  }
+
+  int n_prot = 0;
+
+  struct lgl_bitmap missing = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&missing, &n_prot);
+
+  struct last_complete_cursor cursor = new_last_complete_cursor(&missing);
+
+  slide_index_summary_loop_position(
+    &cursor,
+    window_last_complete,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_last_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  bool complete,
+                                  bool na_rm) {
+  return slide_index_summary_slice(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_last_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_last_core(SEXP x,
+                            SEXP i,
+                            SEXP starts,
+                            SEXP stops,
+                            SEXP peer_sizes,
+                            SEXP complete,
+                            SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_last_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_which_min_core_impl(SEXP x,
+                                             R_xlen_t size,
+                                             int iter_min,
+                                             int iter_max,
+                                             const struct range_info range,
+                                             const int* p_peer_sizes,
+                                             const int* p_peer_starts,
+                                             const int* p_peer_stops,
+                                             bool na_rm,
+                                             struct index_info* p_index,
+                                             int* p_out) {
+  int n_prot = 0;
+
+  struct wedge wedge = new_wedge(x, false, na_rm);
+  PROTECT_WEDGE(&wedge, &n_prot);
+
+  slide_index_summary_loop_position(
+    &wedge,
+    wedge_locate,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_which_min_core(SEXP x,
+                                       SEXP i,
+                                       SEXP starts,
+                                       SEXP stops,
+                                       SEXP peer_sizes,
+                                       bool complete,
+                                       bool na_rm) {
+  return slide_index_summary_position(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_which_min_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_which_min_core(SEXP x,
+                                 SEXP i,
+                                 SEXP starts,
+                                 SEXP stops,
+                                 SEXP peer_sizes,
+                                 SEXP complete,
+                                 SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_which_min_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_which_max_core_impl(SEXP x,
+                                             R_xlen_t size,
+                                             int iter_min,
+                                             int iter_max,
+                                             const struct range_info range,
+                                             const int* p_peer_sizes,
+                                             const int* p_peer_starts,
+                                             const int* p_peer_stops,
+                                             bool na_rm,
+                                             struct index_info* p_index,
+                                             int* p_out) {
+  int n_prot = 0;
+
+  struct wedge wedge = new_wedge(x, true, na_rm);
+  PROTECT_WEDGE(&wedge, &n_prot);
+
+  slide_index_summary_loop_position(
+    &wedge,
+    wedge_locate,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_which_max_core(SEXP x,
+                                       SEXP i,
+                                       SEXP starts,
+                                       SEXP stops,
+                                       SEXP peer_sizes,
+                                       bool complete,
+                                       bool na_rm) {
+  return slide_index_summary_position(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_which_max_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_which_max_core(SEXP x,
+                                 SEXP i,
+                                 SEXP starts,
+                                 SEXP stops,
+                                 SEXP peer_sizes,
+                                 SEXP complete,
+                                 SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_which_max_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_rank_core_impl(SEXP x,
+                                        R_xlen_t size,
+                                        int iter_min,
+                                        int iter_max,
+                                        const struct range_info range,
+                                        const int* p_peer_sizes,
+                                        const int* p_peer_starts,
+                                        const int* p_peer_stops,
+                                        bool na_rm,
+                                        struct index_info* p_index,
+                                        double* p_out) {
+  int n_prot = 0;
+
+  struct window_rank rank = new_window_rank(x, na_rm, false);
+  PROTECT_WINDOW_RANK(&rank, &n_prot);
+
+  slide_index_summary_loop_rank(
+    &rank,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_rank_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  bool complete,
+                                  bool na_rm) {
+  return slide_index_summary_dbl(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_rank_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_rank_core(SEXP x,
+                            SEXP i,
+                            SEXP starts,
+                            SEXP stops,
+                            SEXP peer_sizes,
+                            SEXP complete,
+                            SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_rank_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_n_distinct_core_impl(SEXP x,
+                                              R_xlen_t size,
+                                              int iter_min,
+                                              int iter_max,
+                                              const struct range_info range,
+                                              const int* p_peer_sizes,
+                                              const int* p_peer_starts,
+                                              const int* p_peer_stops,
+                                              bool na_rm,
+                                              struct index_info* p_index,
+                                              int* p_out) {
+  int n_prot = 0;
+
+  struct window_category category = new_window_category(x, na_rm, false);
+  PROTECT_WINDOW_CATEGORY(&category, &n_prot);
+
+  slide_index_summary_loop_n_distinct(
+    &category,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_n_distinct_core(SEXP x,
+                                        SEXP i,
+                                        SEXP starts,
+                                        SEXP stops,
+                                        SEXP peer_sizes,
+                                        bool complete,
+                                        bool na_rm) {
+  return slide_index_summary_count(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_n_distinct_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_n_distinct_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  SEXP complete,
+                                  SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_n_distinct_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_mode_core_impl(SEXP x,
+                                        R_xlen_t size,
+                                        int iter_min,
+                                        int iter_max,
+                                        const struct range_info range,
+                                        const int* p_peer_sizes,
+                                        const int* p_peer_starts,
+                                        const int* p_peer_stops,
+                                        bool na_rm,
+                                        struct index_info* p_index,
+                                        int* p_out) {
+  int n_prot = 0;
+
+  struct window_category category = new_window_category(x, na_rm, true);
+  PROTECT_WINDOW_CATEGORY(&category, &n_prot);
+
+  slide_index_summary_loop_position(
+    &category,
+    window_mode,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_mode_core(SEXP x,
+                                  SEXP i,
+                                  SEXP starts,
+                                  SEXP stops,
+                                  SEXP peer_sizes,
+                                  bool complete,
+                                  bool na_rm) {
+  return slide_index_summary_slice(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_mode_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_mode_core(SEXP x,
+                            SEXP i,
+                            SEXP starts,
+                            SEXP stops,
+                            SEXP peer_sizes,
+                            SEXP complete,
+                            SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_mode_core
+  );
+}
+
+// -----------------------------------------------------------------------------
+
+static void slider_index_entropy_core_impl(SEXP x,
+                                           R_xlen_t size,
+                                           int iter_min,
+                                           int iter_max,
+                                           const struct range_info range,
+                                           const int* p_peer_sizes,
+                                           const int* p_peer_starts,
+                                           const int* p_peer_stops,
+                                           bool na_rm,
+                                           struct index_info* p_index,
+                                           double* p_out) {
+  int n_prot = 0;
+
+  struct window_category category = new_window_category(x, na_rm, false);
+  PROTECT_WINDOW_CATEGORY(&category, &n_prot);
+
+  slide_index_summary_loop_entropy(
+    &category,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    p_index,
+    p_out
+  );
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_index_entropy_core(SEXP x,
+                                     SEXP i,
+                                     SEXP starts,
+                                     SEXP stops,
+                                     SEXP peer_sizes,
+                                     bool complete,
+                                     bool na_rm) {
+  return slide_index_summary_count_dbl(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slider_index_entropy_core_impl
+  );
+}
+
+// [[ register() ]]
+SEXP slider_index_entropy_core(SEXP x,
+                               SEXP i,
+                               SEXP starts,
+                               SEXP stops,
+                               SEXP peer_sizes,
+                               SEXP complete,
+                               SEXP na_rm) {
+  return slider_index_summary(
+    x,
+    i,
+    starts,
+    stops,
+    peer_sizes,
+    complete,
+    na_rm,
+    slide_index_entropy_core
   );
 }
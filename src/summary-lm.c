@@ -0,0 +1,236 @@
+#include "slider.h"
+#include "slider-vctrs.h"
+#include "opts-slide.h"
+#include "utils.h"
+#include "params.h"
+#include "index.h"
+#include "group.h"
+#include "window-lm.h"
+#include "query-counts.h"
+
+// Writes the fit of row `i` into the columns of the `size` row matrix `p_out`
+static inline void lm_fit_write(const double* p_fit, int n_fit, R_xlen_t i, R_xlen_t size, double* p_out) {
+  for (int k = 0; k < n_fit; ++k) {
+    p_out[i + k * size] = p_fit[k];
+  }
+}
+
+static SEXP lm_init(R_xlen_t size, int n_predictors) {
+  const int n_fit = WINDOW_LM_N_FIT(n_predictors);
+
+  SEXP out = PROTECT(slider_init(REALSXP, size * n_fit));
+
+  SEXP dim = Rf_allocVector(INTSXP, 2);
+  Rf_setAttrib(out, R_DimSymbol, dim);
+  INTEGER(dim)[0] = (int) size;
+  INTEGER(dim)[1] = n_fit;
+
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * When sliding by group, the rows have been reordered so that each group is
+ * contiguous. The iterations start over at each group, and windows are clamped
+ * to the rows of the group, so they still never move backwards.
+ */
+static void slide_lm_fill(struct window_lm* p_lm, struct slide_opts opts, double* p_out) {
+  const R_xlen_t size = p_lm->size;
+  const int n_fit = WINDOW_LM_N_FIT(p_lm->n_predictors);
+
+  double* p_fit = (double*) R_alloc(n_fit, sizeof(double));
+
+  const struct iter_opts iopts_all = new_iter_opts(opts, size);
+  const R_xlen_t n_groups = iter_opts_n_groups(&iopts_all);
+
+  R_xlen_t group_start = 0;
+
+  for (R_xlen_t group = 0; group < n_groups; ++group) {
+    const struct iter_opts iopts = iter_opts_group(&iopts_all, group);
+
+    R_xlen_t start = iopts.start;
+    R_xlen_t stop = iopts.stop;
+
+    for (R_xlen_t i = iopts.iter_min; i < iopts.iter_max; i += iopts.iter_step) {
+      const R_xlen_t position = group_start + i;
+
+      if (position % 1024 == 0) {
+        R_CheckUserInterrupt();
+      }
+
+      const R_xlen_t window_start = group_start + max_size(start, 0);
+      const R_xlen_t window_stop = group_start + min_size(stop + 1, iopts.size);
+
+      start += iopts.start_step;
+      stop += iopts.stop_step;
+
+      window_lm_fit(p_lm, window_start, window_stop, p_fit);
+      lm_fit_write(p_fit, n_fit, position, size, p_out);
+    }
+
+    group_start += iopts.size;
+  }
+}
+
+/*
+ * `x` has already been checked and converted to a double matrix with one row
+ * per element of `y`. With `by`, the rows of both are reordered so that each
+ * group is contiguous, and the fits are put back in the original order.
+ */
+// [[ register() ]]
+SEXP slider_lm(SEXP y,
+               SEXP x,
+               SEXP before,
+               SEXP after,
+               SEXP step,
+               SEXP complete,
+               SEXP na_rm,
+               SEXP by) {
+  int n_prot = 0;
+
+  bool dot = false;
+  struct slide_opts opts = new_slide_opts(before, after, step, complete, dot);
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  struct group_info groups = new_group_info(R_NilValue, R_NilValue);
+
+  if (by != R_NilValue) {
+    groups = new_group_info_by(by, vec_size(y), "by");
+    PROTECT_GROUP_INFO(&groups, &n_prot);
+    opts.p_groups = &groups;
+    y = PROTECT_N(group_info_slice(&groups, y), &n_prot);
+    x = PROTECT_N(group_info_slice(&groups, x), &n_prot);
+  }
+
+  y = PROTECT_N(vec_cast(y, slider_shared_empty_dbl), &n_prot);
+
+  struct window_lm lm = new_window_lm(y, x, c_na_rm);
+  PROTECT_WINDOW_LM(&lm, &n_prot);
+
+  SEXP out = PROTECT_N(lm_init(lm.size, lm.n_predictors), &n_prot);
+
+  slide_lm_fill(&lm, opts, REAL(out));
+
+  out = group_info_restore(&groups, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+static void slide_index_lm_fill(struct window_lm* p_lm,
+                                int iter_min,
+                                int iter_max,
+                                const struct range_info range,
+                                const int* p_peer_sizes,
+                                const int* p_peer_starts,
+                                const int* p_peer_stops,
+                                struct index_info* p_index,
+                                double* p_out) {
+  const R_xlen_t size = p_lm->size;
+  const int n_fit = WINDOW_LM_N_FIT(p_lm->n_predictors);
+
+  double* p_fit = (double*) R_alloc(n_fit, sizeof(double));
+
+  struct query_counts counts = new_query_counts();
+
+  int previous_start = -1;
+  int previous_stop = -1;
+
+  for (int i = iter_min; i < iter_max; ++i) {
+    if (i % 1024 == 0) {
+      R_CheckUserInterrupt();
+    }
+
+    int peer_starts_pos = locate_peer_starts_pos(p_index, range, i);
+    int peer_stops_pos = locate_peer_stops_pos(p_index, range, i);
+
+    int window_start;
+    int window_stop;
+
+    if (peer_stops_pos < peer_starts_pos) {
+      // Signal that the window selection was completely OOB
+      window_start = 0;
+      window_stop = 0;
+    } else {
+      window_start = p_peer_starts[peer_starts_pos];
+      window_stop = p_peer_stops[peer_stops_pos] + 1;
+    }
+
+    ++counts.n_queries;
+
+    // Runs of peer groups with the same window reuse its fit
+    if (window_start == previous_start && window_stop == previous_stop) {
+      ++counts.n_reused;
+    } else {
+      window_lm_fit(p_lm, window_start, window_stop, p_fit);
+      previous_start = window_start;
+      previous_stop = window_stop;
+    }
+
+    int peer_start = p_peer_starts[i];
+    int peer_size = p_peer_sizes[i];
+
+    for (int j = 0; j < peer_size; ++j) {
+      lm_fit_write(p_fit, n_fit, peer_start, size, p_out);
+      ++peer_start;
+    }
+  }
+
+  query_counts_record(counts);
+}
+
+// [[ register() ]]
+SEXP slider_index_lm_core(SEXP y,
+                          SEXP x,
+                          SEXP i,
+                          SEXP starts,
+                          SEXP stops,
+                          SEXP peer_sizes,
+                          SEXP complete,
+                          SEXP na_rm) {
+  int n_prot = 0;
+
+  bool dot = false;
+  bool c_complete = validate_complete(complete, dot);
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  y = PROTECT_N(vec_cast(y, slider_shared_empty_dbl), &n_prot);
+
+  struct window_lm lm = new_window_lm(y, x, c_na_rm);
+  PROTECT_WINDOW_LM(&lm, &n_prot);
+
+  SEXP out = PROTECT_N(lm_init(lm.size, lm.n_predictors), &n_prot);
+
+  struct index_info index = new_index_info(i);
+  PROTECT_INDEX_INFO(&index, &n_prot);
+
+  const int* p_peer_sizes = INTEGER_RO(peer_sizes);
+  int* p_peer_starts = (int*) R_alloc(index.size, sizeof(int));
+  int* p_peer_stops = (int*) R_alloc(index.size, sizeof(int));
+  fill_peer_info(p_peer_sizes, index.size, p_peer_starts, p_peer_stops);
+
+  struct range_info range = new_range_info(starts, stops, index.size);
+  PROTECT_RANGE_INFO(&range, &n_prot);
+
+  const int iter_min = compute_min_iteration(index, range, c_complete);
+  const int iter_max = compute_max_iteration(index, range, c_complete);
+
+  slide_index_lm_fill(
+    &lm,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    &index,
+    REAL(out)
+  );
+
+  UNPROTECT(n_prot);
+  return out;
+}
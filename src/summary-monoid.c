@@ -0,0 +1,525 @@
+#include "slider.h"
+#include "slider-vctrs.h"
+#include "opts-slide.h"
+#include "utils.h"
+#include "params.h"
+#include "index.h"
+#include "group.h"
+#include "align.h"
+#include "segment-tree.h"
+#include "summary-core.h"
+#include "query-counts.h"
+#include "../inst/include/slider.h"
+
+/*
+ * The segment tree callbacks don't take a context, so the monoid being
+ * aggregated is kept here for the duration of each call. It is saved and
+ * restored around the call rather than cleared, so a monoid is never left
+ * dangling by a nested call.
+ */
+static const struct slider_monoid* p_current_monoid = NULL;
+
+static void monoid_state_reset(void* p_state) {
+  p_current_monoid->identity(p_state);
+}
+
+static void monoid_state_finalize(void* p_state, void* p_result) {
+  p_current_monoid->finalize(p_state, (double*) p_result);
+}
+
+static void* monoid_nodes_increment(void* p_nodes) {
+  return (void*) (((unsigned char*) p_nodes) + p_current_monoid->size);
+}
+
+static void* monoid_nodes_void_deref(SEXP nodes) {
+  return aligned_void_deref(nodes, p_current_monoid->align);
+}
+
+static SEXP monoid_nodes_initialize(uint64_t n) {
+  const struct slider_monoid* p_monoid = p_current_monoid;
+
+  SEXP nodes = PROTECT(aligned_allocate(n, p_monoid->size, p_monoid->align));
+  unsigned char* p_nodes = (unsigned char*) monoid_nodes_void_deref(nodes);
+
+  for (uint64_t i = 0; i < n; ++i) {
+    p_monoid->identity(p_nodes + i * p_monoid->size);
+  }
+
+  UNPROTECT(1);
+  return nodes;
+}
+
+static void monoid_na_keep_aggregate_from_leaves(const void* p_source,
+                                                 uint64_t begin,
+                                                 uint64_t end,
+                                                 void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  void (*push)(void*, double) = p_current_monoid->push;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    push(p_dest, p_source_[i]);
+  }
+}
+
+static void monoid_na_rm_aggregate_from_leaves(const void* p_source,
+                                               uint64_t begin,
+                                               uint64_t end,
+                                               void* p_dest) {
+  const double* p_source_ = (const double*) p_source;
+  void (*push)(void*, double) = p_current_monoid->push;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    const double elt = p_source_[i];
+
+    if (!isnan(elt)) {
+      push(p_dest, elt);
+    }
+  }
+}
+
+static void monoid_aggregate_from_nodes(const void* p_source,
+                                        uint64_t begin,
+                                        uint64_t end,
+                                        void* p_dest) {
+  const unsigned char* p_source_ = (const unsigned char*) p_source;
+  const size_t size = p_current_monoid->size;
+  void (*combine)(void*, const void*) = p_current_monoid->combine;
+
+  for (uint64_t i = begin; i < end; ++i) {
+    combine(p_dest, p_source_ + i * size);
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+static inline bool is_power_of_two(size_t x) {
+  return x != 0 && (x & (x - 1)) == 0;
+}
+
+// Registered as a C callable, see `inst/include/slider.h`
+SEXP exp_new_monoid(const struct slider_monoid* p_monoid) {
+  if (p_monoid == NULL) {
+    Rf_errorcall(R_NilValue, "Internal error: `p_monoid` can't be `NULL`.");
+  }
+  if (p_monoid->version < 1 || p_monoid->version > SLIDER_MONOID_VERSION) {
+    Rf_errorcall(
+      R_NilValue,
+      "Can't use a monoid of version %d, this version of slider supports versions 1 to %d.",
+      p_monoid->version,
+      SLIDER_MONOID_VERSION
+    );
+  }
+  if (p_monoid->size == 0) {
+    Rf_errorcall(R_NilValue, "The `size` of a monoid must be positive.");
+  }
+  if (!is_power_of_two(p_monoid->align) || p_monoid->size % p_monoid->align != 0) {
+    Rf_errorcall(R_NilValue, "The `align` of a monoid must be a power of 2 that divides its `size`.");
+  }
+  if (p_monoid->identity == NULL ||
+      p_monoid->push == NULL ||
+      p_monoid->combine == NULL ||
+      p_monoid->finalize == NULL) {
+    Rf_errorcall(R_NilValue, "The callbacks of a monoid can't be `NULL`.");
+  }
+
+  SEXP data = PROTECT(Rf_allocVector(RAWSXP, sizeof(struct slider_monoid)));
+  struct slider_monoid* p_data = (struct slider_monoid*) RAW(data);
+  *p_data = *p_monoid;
+  p_data->version = SLIDER_MONOID_VERSION;
+
+  SEXP out = PROTECT(R_MakeExternalPtr(p_data, R_NilValue, data));
+  Rf_setAttrib(out, R_ClassSymbol, Rf_mkString("slider_monoid"));
+
+  UNPROTECT(2);
+  return out;
+}
+
+static const struct slider_monoid* monoid_deref(SEXP monoid) {
+  if (TYPEOF(monoid) != EXTPTRSXP || !Rf_inherits(monoid, "slider_monoid")) {
+    Rf_errorcall(R_NilValue, "`monoid` must be a monoid created with `slider_new_monoid()`.");
+  }
+
+  const struct slider_monoid* p_monoid = (const struct slider_monoid*) R_ExternalPtrAddr(monoid);
+
+  // External pointers don't survive serialization
+  if (p_monoid == NULL) {
+    Rf_errorcall(R_NilValue, "`monoid` is no longer valid. Was it saved and reloaded?");
+  }
+
+  return p_monoid;
+}
+
+// Switches the current monoid, returning the previous one
+static const struct slider_monoid* monoid_enter(SEXP monoid) {
+  const struct slider_monoid* p_previous = p_current_monoid;
+  p_current_monoid = monoid_deref(monoid);
+  return p_previous;
+}
+
+static void monoid_exit(const struct slider_monoid* p_previous) {
+  p_current_monoid = p_previous;
+}
+
+struct monoid_tree {
+  SEXP state;
+  struct segment_tree tree;
+};
+
+#define PROTECT_MONOID_TREE(p_monoid_tree, p_n) do { \
+  PROTECT((p_monoid_tree)->state);                   \
+  *(p_n) += 1;                                       \
+  PROTECT_SEGMENT_TREE(&(p_monoid_tree)->tree, p_n); \
+} while (0)
+
+static struct monoid_tree new_monoid_tree(SEXP x, bool na_rm) {
+  SEXP state = PROTECT(aligned_allocate(1, p_current_monoid->size, p_current_monoid->align));
+  void* p_state = aligned_void_deref(state, p_current_monoid->align);
+
+  struct segment_tree tree = new_segment_tree(
+    Rf_xlength(x),
+    x,
+    p_state,
+    monoid_state_reset,
+    monoid_state_finalize,
+    monoid_nodes_increment,
+    monoid_nodes_initialize,
+    monoid_nodes_void_deref,
+    na_rm ? monoid_na_rm_aggregate_from_leaves : monoid_na_keep_aggregate_from_leaves,
+    monoid_aggregate_from_nodes
+  );
+
+  UNPROTECT(1);
+
+  return (struct monoid_tree) {
+    .state = state,
+    .tree = tree
+  };
+}
+
+// -----------------------------------------------------------------------------
+
+// When sliding by group, the iterations start over at each group, and windows
+// are clamped to the rows of the group
+static void slide_monoid_fill(const struct segment_tree* p_tree,
+                              const struct iter_opts* p_opts,
+                              double* p_out) {
+  const R_xlen_t n_groups = iter_opts_n_groups(p_opts);
+
+  R_xlen_t group_start = 0;
+
+  for (R_xlen_t group = 0; group < n_groups; ++group) {
+    const struct iter_opts iopts = iter_opts_group(p_opts, group);
+
+    R_xlen_t start = iopts.start;
+    R_xlen_t stop = iopts.stop;
+
+    for (R_xlen_t i = iopts.iter_min; i < iopts.iter_max; i += iopts.iter_step) {
+      const R_xlen_t position = group_start + i;
+
+      if (position % 1024 == 0) {
+        R_CheckUserInterrupt();
+      }
+
+      R_xlen_t window_start = max_size(start, 0);
+      R_xlen_t window_stop = min_size(stop + 1, iopts.size);
+
+      // Happens when the entire window is OOB
+      if (window_stop < window_start) {
+        window_start = 0;
+        window_stop = 0;
+      }
+
+      start += iopts.start_step;
+      stop += iopts.stop_step;
+
+      segment_tree_aggregate(
+        p_tree,
+        group_start + window_start,
+        group_start + window_stop,
+        &p_out[position]
+      );
+    }
+
+    group_start += iopts.size;
+  }
+}
+
+// [[ register() ]]
+SEXP slider_monoid(SEXP x,
+                   SEXP monoid,
+                   SEXP before,
+                   SEXP after,
+                   SEXP step,
+                   SEXP complete,
+                   SEXP na_rm,
+                   SEXP by) {
+  int n_prot = 0;
+
+  bool dot = false;
+  struct slide_opts opts = new_slide_opts(before, after, step, complete, dot);
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  struct group_info groups = new_group_info(R_NilValue, R_NilValue);
+
+  if (by != R_NilValue) {
+    groups = new_group_info_by(by, vec_size(x), "by");
+    PROTECT_GROUP_INFO(&groups, &n_prot);
+    opts.p_groups = &groups;
+    x = PROTECT_N(group_info_slice(&groups, x), &n_prot);
+  }
+
+  const struct slider_monoid* p_previous = monoid_enter(monoid);
+
+  // Before `vec_cast()`, which may drop names
+  SEXP names = PROTECT_N(slider_names(x, SLIDE), &n_prot);
+
+  x = PROTECT_N(vec_cast(x, slider_shared_empty_dbl), &n_prot);
+
+  const R_xlen_t size = Rf_xlength(x);
+  const struct iter_opts iopts = new_iter_opts(opts, size);
+
+  SEXP out = PROTECT_N(slider_init(REALSXP, size), &n_prot);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  struct monoid_tree tree = new_monoid_tree(x, c_na_rm);
+  PROTECT_MONOID_TREE(&tree, &n_prot);
+
+  slide_monoid_fill(&tree.tree, &iopts, REAL(out));
+
+  monoid_exit(p_previous);
+
+  out = group_info_restore(&groups, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+static void slide_index_monoid_fill(const struct segment_tree* p_tree,
+                                    int iter_min,
+                                    int iter_max,
+                                    const struct range_info range,
+                                    const int* p_peer_sizes,
+                                    const int* p_peer_starts,
+                                    const int* p_peer_stops,
+                                    struct index_info* p_index,
+                                    double* p_out) {
+  struct query_counts counts = new_query_counts();
+
+  int previous_start = -1;
+  int previous_stop = -1;
+  double previous = 0;
+
+  for (int i = iter_min; i < iter_max; ++i) {
+    if (i % 1024 == 0) {
+      R_CheckUserInterrupt();
+    }
+
+    int peer_starts_pos = locate_peer_starts_pos(p_index, range, i);
+    int peer_stops_pos = locate_peer_stops_pos(p_index, range, i);
+
+    int window_start;
+    int window_stop;
+
+    if (peer_stops_pos < peer_starts_pos) {
+      // Signal that the window selection was completely OOB
+      window_start = 0;
+      window_stop = 0;
+    } else {
+      window_start = p_peer_starts[peer_starts_pos];
+      window_stop = p_peer_stops[peer_stops_pos] + 1;
+    }
+
+    double result;
+
+    ++counts.n_queries;
+
+    // Runs of peer groups with the same window reuse its result
+    if (window_start == previous_start && window_stop == previous_stop) {
+      result = previous;
+      ++counts.n_reused;
+    } else {
+      segment_tree_aggregate(p_tree, window_start, window_stop, &result);
+      previous = result;
+      previous_start = window_start;
+      previous_stop = window_stop;
+    }
+
+    const int peer_start = p_peer_starts[i];
+    const int peer_stop = peer_start + p_peer_sizes[i];
+
+    for (int j = peer_start; j < peer_stop; ++j) {
+      p_out[j] = result;
+    }
+  }
+
+  query_counts_record(counts);
+}
+
+// [[ register() ]]
+SEXP slider_index_monoid_core(SEXP x,
+                              SEXP i,
+                              SEXP starts,
+                              SEXP stops,
+                              SEXP peer_sizes,
+                              SEXP complete,
+                              SEXP na_rm,
+                              SEXP monoid) {
+  int n_prot = 0;
+
+  bool dot = false;
+  bool c_complete = validate_complete(complete, dot);
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  const struct slider_monoid* p_previous = monoid_enter(monoid);
+
+  // Before `vec_cast()`, which may drop names
+  SEXP names = PROTECT_N(slider_names(x, SLIDE), &n_prot);
+
+  x = PROTECT_N(vec_cast(x, slider_shared_empty_dbl), &n_prot);
+
+  const R_xlen_t size = Rf_xlength(x);
+
+  SEXP out = PROTECT_N(slider_init(REALSXP, size), &n_prot);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  struct monoid_tree tree = new_monoid_tree(x, c_na_rm);
+  PROTECT_MONOID_TREE(&tree, &n_prot);
+
+  struct index_info index = new_index_info(i);
+  PROTECT_INDEX_INFO(&index, &n_prot);
+
+  const int* p_peer_sizes = INTEGER_RO(peer_sizes);
+  int* p_peer_starts = (int*) R_alloc(index.size, sizeof(int));
+  int* p_peer_stops = (int*) R_alloc(index.size, sizeof(int));
+  fill_peer_info(p_peer_sizes, index.size, p_peer_starts, p_peer_stops);
+
+  struct range_info range = new_range_info(starts, stops, index.size);
+  PROTECT_RANGE_INFO(&range, &n_prot);
+
+  const int iter_min = compute_min_iteration(index, range, c_complete);
+  const int iter_max = compute_max_iteration(index, range, c_complete);
+
+  slide_index_monoid_fill(
+    &tree.tree,
+    iter_min,
+    iter_max,
+    range,
+    p_peer_sizes,
+    p_peer_starts,
+    p_peer_stops,
+    &index,
+    REAL(out)
+  );
+
+  monoid_exit(p_previous);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+// `starts` and `stops` are 1-based positions, and like `hop()`, only the part
+// of each window that is within `x` is aggregated. Repeated ranges reuse the
+// result of the range before them.
+static void hop_monoid_fill(const struct segment_tree* p_tree,
+                            R_xlen_t x_size,
+                            R_xlen_t size,
+                            const int* p_starts,
+                            const int* p_stops,
+                            double* p_out) {
+  struct query_counts counts = new_query_counts();
+
+  R_xlen_t previous_start = -1;
+  R_xlen_t previous_stop = -1;
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    if (i % 1024 == 0) {
+      R_CheckUserInterrupt();
+    }
+
+    R_xlen_t window_start = max_size((R_xlen_t) p_starts[i] - 1, 0);
+    R_xlen_t window_stop = min_size((R_xlen_t) p_stops[i], x_size);
+
+    if (window_stop < window_start) {
+      window_start = 0;
+      window_stop = 0;
+    }
+
+    ++counts.n_queries;
+
+    if (window_start == previous_start && window_stop == previous_stop) {
+      p_out[i] = p_out[i - 1];
+      ++counts.n_reused;
+      continue;
+    }
+
+    segment_tree_aggregate(p_tree, window_start, window_stop, &p_out[i]);
+
+    previous_start = window_start;
+    previous_stop = window_stop;
+  }
+
+  query_counts_record(counts);
+}
+
+// [[ register() ]]
+SEXP slider_hop_monoid(SEXP x, SEXP starts, SEXP stops, SEXP monoid, SEXP na_rm) {
+  int n_prot = 0;
+
+  bool dot = false;
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  const struct slider_monoid* p_previous = monoid_enter(monoid);
+
+  x = PROTECT_N(vec_cast(x, slider_shared_empty_dbl), &n_prot);
+
+  const R_xlen_t x_size = Rf_xlength(x);
+  const R_xlen_t size = Rf_xlength(starts);
+
+  SEXP out = PROTECT_N(Rf_allocVector(REALSXP, size), &n_prot);
+
+  struct monoid_tree tree = new_monoid_tree(x, c_na_rm);
+  PROTECT_MONOID_TREE(&tree, &n_prot);
+
+  hop_monoid_fill(&tree.tree, x_size, size, INTEGER_RO(starts), INTEGER_RO(stops), REAL(out));
+
+  monoid_exit(p_previous);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+// A sum, for the tests of the API
+
+static void example_sum_identity(void* p_node) {
+  *((long double*) p_node) = 0;
+}
+static void example_sum_push(void* p_node, double x) {
+  *((long double*) p_node) += x;
+}
+static void example_sum_combine(void* p_left, const void* p_right) {
+  *((long double*) p_left) += *((const long double*) p_right);
+}
+static void example_sum_finalize(const void* p_node, double* p_out) {
+  *p_out = (double) *((const long double*) p_node);
+}
+
+// [[ register() ]]
+SEXP slider_example_monoid() {
+  struct slider_monoid monoid = {
+    .version = SLIDER_MONOID_VERSION,
+    .size = sizeof(long double),
+    .align = align_of_long_double(),
+    .identity = example_sum_identity,
+    .push = example_sum_push,
+    .combine = example_sum_combine,
+    .finalize = example_sum_finalize
+  };
+
+  return exp_new_monoid(&monoid);
+}
@@ -0,0 +1,436 @@
+#include "slider.h"
+#include "slider-vctrs.h"
+#include "opts-slide.h"
+#include "utils.h"
+#include "params.h"
+#include "index.h"
+#include "group.h"
+#include "columns.h"
+#include "window-rank.h"
+#include "query-counts.h"
+
+// Scales the MAD into a consistent estimate of the standard deviation of
+// normally distributed data, like the default `constant` of `mad()`
+#define HAMPEL_MAD_CONSTANT 1.4826
+
+enum robust_type {
+  ROBUST_MAD,
+  ROBUST_HAMPEL,
+  ROBUST_TRIMMED_MEAN
+};
+
+struct robust_opts {
+  enum robust_type type;
+
+  // `constant` for the MAD, `k * HAMPEL_MAD_CONSTANT` for Hampel's filter,
+  // and `trim` for the trimmed mean
+  double scale;
+};
+
+/*
+ * Summarizes `[begin, end)` into its `center` and `spread`, returning `false`
+ * when the window has no result. The trimmed mean is its own center.
+ */
+static inline bool robust_window(struct window_rank* p_rank,
+                                 const struct robust_opts* p_opts,
+                                 R_xlen_t begin,
+                                 R_xlen_t end,
+                                 double* p_center,
+                                 double* p_spread) {
+  switch (p_opts->type) {
+  case ROBUST_MAD:
+  case ROBUST_HAMPEL: {
+    return window_rank_mad(p_rank, begin, end, p_center, p_spread);
+  }
+  case ROBUST_TRIMMED_MEAN: {
+    *p_center = window_rank_trimmed_mean(p_rank, begin, end, p_opts->scale);
+    return true;
+  }
+  }
+
+  never_reached("robust_window");
+}
+
+/*
+ * Result of `x[position]` from the summary of its window, the median and
+ * unscaled MAD for all but the trimmed mean. Hampel's filter replaces values
+ * further than `scale * mad` from the median with the median, and keeps the
+ * others.
+ */
+static inline double robust_result(const struct window_rank* p_rank,
+                                   const struct robust_opts* p_opts,
+                                   double center,
+                                   double spread,
+                                   R_xlen_t position) {
+  switch (p_opts->type) {
+  case ROBUST_MAD: {
+    return p_opts->scale * spread;
+  }
+  case ROBUST_TRIMMED_MEAN: {
+    return center;
+  }
+  case ROBUST_HAMPEL: {
+    const double elt = window_rank_value(p_rank, position);
+
+    if (isnan(elt) || isnan(spread)) {
+      return NA_REAL;
+    }
+
+    return fabs(elt - center) > p_opts->scale * spread ? center : elt;
+  }
+  }
+
+  never_reached("robust_result");
+}
+
+static struct robust_opts new_robust_opts(enum robust_type type, SEXP scale) {
+  switch (type) {
+  case ROBUST_MAD: {
+    return (struct robust_opts) {
+      .type = type,
+      .scale = validate_constant(scale)
+    };
+  }
+  case ROBUST_HAMPEL: {
+    return (struct robust_opts) {
+      .type = type,
+      .scale = validate_k(scale) * HAMPEL_MAD_CONSTANT
+    };
+  }
+  case ROBUST_TRIMMED_MEAN: {
+    return (struct robust_opts) {
+      .type = type,
+      .scale = validate_trim(scale)
+    };
+  }
+  }
+
+  never_reached("new_robust_opts");
+}
+
+// -----------------------------------------------------------------------------
+
+// Like `SLIDE_SUMMARY_LOOP()`, starting over at each group when sliding by
+// group
+static void slide_robust_fill(struct window_rank* p_rank,
+                              const struct iter_opts* p_opts,
+                              const struct robust_opts* p_robust,
+                              double* p_out) {
+  const R_xlen_t n_groups = iter_opts_n_groups(p_opts);
+
+  R_xlen_t group_start = 0;
+
+  for (R_xlen_t group = 0; group < n_groups; ++group) {
+    const struct iter_opts iopts = iter_opts_group(p_opts, group);
+
+    R_xlen_t start = iopts.start;
+    R_xlen_t stop = iopts.stop;
+
+    for (R_xlen_t i = iopts.iter_min; i < iopts.iter_max; i += iopts.iter_step) {
+      const R_xlen_t position = group_start + i;
+
+      if (position % 1024 == 0) {
+        R_CheckUserInterrupt();
+      }
+
+      const R_xlen_t window_start = group_start + max_size(start, 0);
+      const R_xlen_t window_stop = group_start + min_size(stop + 1, iopts.size);
+
+      start += iopts.start_step;
+      stop += iopts.stop_step;
+
+      double center;
+      double spread;
+
+      if (robust_window(p_rank, p_robust, window_start, window_stop, &center, &spread)) {
+        p_out[position] = robust_result(p_rank, p_robust, center, spread, position);
+      }
+    }
+
+    group_start += iopts.size;
+  }
+}
+
+static SEXP slide_robust(SEXP x,
+                         SEXP before,
+                         SEXP after,
+                         SEXP step,
+                         SEXP complete,
+                         SEXP na_rm,
+                         SEXP by,
+                         struct robust_opts robust) {
+  int n_prot = 0;
+
+  bool dot = false;
+  struct slide_opts opts = new_slide_opts(before, after, step, complete, dot);
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  // With `by`, each group is made contiguous, see `slide_summary_by()`
+  struct group_info groups = new_group_info(R_NilValue, R_NilValue);
+
+  if (by != R_NilValue) {
+    groups = new_group_info_by(by, vec_size(x), "by");
+    opts.p_groups = &groups;
+  }
+
+  PROTECT_GROUP_INFO(&groups, &n_prot);
+
+  x = PROTECT_N(group_info_slice(&groups, x), &n_prot);
+
+  // Matrices and data frames are summarized column by column, see `columns.h`
+  SEXP out = PROTECT_N(columns_init(x, REALSXP), &n_prot);
+  const R_xlen_t n_columns = columns_n(x);
+
+  for (R_xlen_t j = 0; j < n_columns; ++j) {
+    int n_prot_column = 0;
+
+    SEXP column = PROTECT_N(columns_get(x, j), &n_prot_column);
+
+    // Before `vec_cast()`, which may drop names
+    SEXP names = PROTECT_N(slider_names(column, SLIDE), &n_prot_column);
+
+    column = PROTECT_N(vec_cast(column, slider_shared_empty_dbl), &n_prot_column);
+
+    const R_xlen_t size = Rf_xlength(column);
+    const struct iter_opts iopts = new_iter_opts(opts, size);
+
+    SEXP out_column = PROTECT_N(slider_init(REALSXP, size), &n_prot_column);
+    Rf_setAttrib(out_column, R_NamesSymbol, names);
+
+    struct window_rank rank = new_window_rank(column, c_na_rm, robust.type == ROBUST_TRIMMED_MEAN);
+    PROTECT_WINDOW_RANK(&rank, &n_prot_column);
+
+    slide_robust_fill(&rank, &iopts, &robust, REAL(out_column));
+
+    columns_set(x, out, j, out_column);
+    UNPROTECT(n_prot_column);
+  }
+
+  out = columns_finalize(x, out);
+  out = group_info_restore(&groups, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// [[ register() ]]
+SEXP slider_mad(SEXP x,
+                SEXP before,
+                SEXP after,
+                SEXP step,
+                SEXP complete,
+                SEXP na_rm,
+                SEXP constant,
+                SEXP by) {
+  struct robust_opts robust = new_robust_opts(ROBUST_MAD, constant);
+  return slide_robust(x, before, after, step, complete, na_rm, by, robust);
+}
+
+// [[ register() ]]
+SEXP slider_hampel(SEXP x,
+                   SEXP before,
+                   SEXP after,
+                   SEXP step,
+                   SEXP complete,
+                   SEXP na_rm,
+                   SEXP k,
+                   SEXP by) {
+  struct robust_opts robust = new_robust_opts(ROBUST_HAMPEL, k);
+  return slide_robust(x, before, after, step, complete, na_rm, by, robust);
+}
+
+// [[ register() ]]
+SEXP slider_trimmed_mean(SEXP x,
+                         SEXP before,
+                         SEXP after,
+                         SEXP step,
+                         SEXP complete,
+                         SEXP na_rm,
+                         SEXP trim,
+                         SEXP by) {
+  struct robust_opts robust = new_robust_opts(ROBUST_TRIMMED_MEAN, trim);
+  return slide_robust(x, before, after, step, complete, na_rm, by, robust);
+}
+
+// -----------------------------------------------------------------------------
+
+// Peers share the summary of their window, but Hampel's filter still compares
+// each of them to it
+static void slide_index_robust_fill(struct window_rank* p_rank,
+                                    const struct robust_opts* p_robust,
+                                    int iter_min,
+                                    int iter_max,
+                                    const struct range_info range,
+                                    const int* p_peer_sizes,
+                                    const int* p_peer_starts,
+                                    const int* p_peer_stops,
+                                    struct index_info* p_index,
+                                    double* p_out) {
+  struct query_counts counts = new_query_counts();
+
+  int previous_start = -1;
+  int previous_stop = -1;
+  bool ok = false;
+
+  double center = NA_REAL;
+  double spread = NA_REAL;
+
+  for (int i = iter_min; i < iter_max; ++i) {
+    if (i % 1024 == 0) {
+      R_CheckUserInterrupt();
+    }
+
+    int peer_starts_pos = locate_peer_starts_pos(p_index, range, i);
+    int peer_stops_pos = locate_peer_stops_pos(p_index, range, i);
+
+    int window_start;
+    int window_stop;
+
+    if (peer_stops_pos < peer_starts_pos) {
+      // Signal that the window selection was completely OOB
+      window_start = 0;
+      window_stop = 0;
+    } else {
+      window_start = p_peer_starts[peer_starts_pos];
+      window_stop = p_peer_stops[peer_stops_pos] + 1;
+    }
+
+    ++counts.n_queries;
+
+    // Runs of peer groups with the same window reuse its summary
+    if (window_start == previous_start && window_stop == previous_stop) {
+      ++counts.n_reused;
+    } else {
+      ok = robust_window(p_rank, p_robust, window_start, window_stop, &center, &spread);
+      previous_start = window_start;
+      previous_stop = window_stop;
+    }
+
+    if (!ok) {
+      continue;
+    }
+
+    const int peer_start = p_peer_starts[i];
+    const int peer_stop = peer_start + p_peer_sizes[i];
+
+    for (int j = peer_start; j < peer_stop; ++j) {
+      p_out[j] = robust_result(p_rank, p_robust, center, spread, j);
+    }
+  }
+
+  query_counts_record(counts);
+}
+
+static SEXP slide_index_robust_core(SEXP x,
+                                    SEXP i,
+                                    SEXP starts,
+                                    SEXP stops,
+                                    SEXP peer_sizes,
+                                    SEXP complete,
+                                    SEXP na_rm,
+                                    struct robust_opts robust) {
+  int n_prot = 0;
+
+  bool dot = false;
+  bool c_complete = validate_complete(complete, dot);
+  bool c_na_rm = validate_na_rm(na_rm, dot);
+
+  struct index_info index = new_index_info(i);
+  PROTECT_INDEX_INFO(&index, &n_prot);
+
+  const int* p_peer_sizes = INTEGER_RO(peer_sizes);
+  int* p_peer_starts = (int*) R_alloc(index.size, sizeof(int));
+  int* p_peer_stops = (int*) R_alloc(index.size, sizeof(int));
+  fill_peer_info(p_peer_sizes, index.size, p_peer_starts, p_peer_stops);
+
+  struct range_info range = new_range_info(starts, stops, index.size);
+  PROTECT_RANGE_INFO(&range, &n_prot);
+
+  const int iter_min = compute_min_iteration(index, range, c_complete);
+  const int iter_max = compute_max_iteration(index, range, c_complete);
+
+  // The windows are shared by the columns of matrices and data frames
+  SEXP out = PROTECT_N(columns_init(x, REALSXP), &n_prot);
+  const R_xlen_t n_columns = columns_n(x);
+
+  for (R_xlen_t j = 0; j < n_columns; ++j) {
+    int n_prot_column = 0;
+
+    SEXP column = PROTECT_N(columns_get(x, j), &n_prot_column);
+
+    // Before `vec_cast()`, which may drop names
+    SEXP names = PROTECT_N(slider_names(column, SLIDE), &n_prot_column);
+
+    column = PROTECT_N(vec_cast(column, slider_shared_empty_dbl), &n_prot_column);
+
+    const R_xlen_t size = Rf_xlength(column);
+
+    SEXP out_column = PROTECT_N(slider_init(REALSXP, size), &n_prot_column);
+    Rf_setAttrib(out_column, R_NamesSymbol, names);
+
+    struct window_rank rank = new_window_rank(column, c_na_rm, robust.type == ROBUST_TRIMMED_MEAN);
+    PROTECT_WINDOW_RANK(&rank, &n_prot_column);
+
+    struct index_info column_index = index;
+
+    slide_index_robust_fill(
+      &rank,
+      &robust,
+      iter_min,
+      iter_max,
+      range,
+      p_peer_sizes,
+      p_peer_starts,
+      p_peer_stops,
+      &column_index,
+      REAL(out_column)
+    );
+
+    columns_set(x, out, j, out_column);
+    UNPROTECT(n_prot_column);
+  }
+
+  out = columns_finalize(x, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
+// [[ register() ]]
+SEXP slider_index_mad_core(SEXP x,
+                           SEXP i,
+                           SEXP starts,
+                           SEXP stops,
+                           SEXP peer_sizes,
+                           SEXP complete,
+                           SEXP na_rm,
+                           SEXP constant) {
+  struct robust_opts robust = new_robust_opts(ROBUST_MAD, constant);
+  return slide_index_robust_core(x, i, starts, stops, peer_sizes, complete, na_rm, robust);
+}
+
+// [[ register() ]]
+SEXP slider_index_hampel_core(SEXP x,
+                              SEXP i,
+                              SEXP starts,
+                              SEXP stops,
+                              SEXP peer_sizes,
+                              SEXP complete,
+                              SEXP na_rm,
+                              SEXP k) {
+  struct robust_opts robust = new_robust_opts(ROBUST_HAMPEL, k);
+  return slide_index_robust_core(x, i, starts, stops, peer_sizes, complete, na_rm, robust);
+}
+
+// [[ register() ]]
+SEXP slider_index_trimmed_mean_core(SEXP x,
+                                    SEXP i,
+                                    SEXP starts,
+                                    SEXP stops,
+                                    SEXP peer_sizes,
+                                    SEXP complete,
+                                    SEXP na_rm,
+                                    SEXP trim) {
+  struct robust_opts robust = new_robust_opts(ROBUST_TRIMMED_MEAN, trim);
+  return slide_index_robust_core(x, i, starts, stops, peer_sizes, complete, na_rm, robust);
+}
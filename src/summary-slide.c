@@ -2,58 +2,119 @@
 #include "slider-vctrs.h"
 #include "opts-slide.h"
 #include "utils.h"
+#include "group.h"
+#include "columns.h"
 #include "segment-tree.h"
+#include "parallel.h"
+#include "bitmap.h"
+#include "window-position.h"
+#include "window-rank.h"
+#include "window-category.h"
 #include "summary-core.h"
 
 // -----------------------------------------------------------------------------
 
 typedef SEXP (*summary_fn)(SEXP x, struct slide_opts opts, bool na_rm);
 
+/*
+ * With `by`, the rows of `x` are reordered so that each group is contiguous,
+ * the windows of all groups are summarized in one pass, and the result is put
+ * back in the original order of the rows
+ */
+static SEXP slide_summary_by(SEXP x,
+                             struct slide_opts opts,
+                             bool na_rm,
+                             SEXP by,
+                             summary_fn fn) {
+  if (by == R_NilValue) {
+    return fn(x, opts, na_rm);
+  }
+
+  int n_prot = 0;
+
+  struct group_info groups = new_group_info_by(by, vec_size(x), "by");
+  PROTECT_GROUP_INFO(&groups, &n_prot);
+
+  opts.p_groups = &groups;
+
+  x = PROTECT_N(group_info_slice(&groups, x), &n_prot);
+
+  SEXP out = PROTECT_N(fn(x, opts, na_rm), &n_prot);
+  out = group_info_restore(&groups, out);
+
+  UNPROTECT(n_prot);
+  return out;
+}
+
 static SEXP slider_summary(SEXP x,
                            SEXP before,
                            SEXP after,
                            SEXP step,
                            SEXP complete,
                            SEXP na_rm,
+                           SEXP by,
                            summary_fn fn) {
   bool dot = false;
   struct slide_opts opts = new_slide_opts(before, after, step, complete, dot);
   bool c_na_rm = validate_na_rm(na_rm, dot);
-  return fn(x, opts, c_na_rm);
+  return slide_summary_by(x, opts, c_na_rm, by, fn);
 }
 
 // -----------------------------------------------------------------------------
 
-typedef void (*summary_impl_dbl_fn)(const double* p_x,
+typedef void (*summary_impl_dbl_fn)(SEXP x,
                                     R_xlen_t size,
                                     const struct iter_opts* p_opts,
                                     bool na_rm,
                                     double* p_out);
 
-typedef void (*summary_impl_lgl_fn)(const int* p_x,
+typedef void (*summary_impl_lgl_fn)(SEXP x,
+                                    R_xlen_t size,
+                                    const struct iter_opts* p_opts,
+                                    bool na_rm,
+                                    int* p_out);
+
+typedef void (*summary_impl_int_fn)(SEXP x,
                                     R_xlen_t size,
                                     const struct iter_opts* p_opts,
                                     bool na_rm,
                                     int* p_out);
 
-#define SLIDE_SUMMARY(PTYPE, CTYPE, SEXPTYPE, CONST_DEREF, DEREF) do { \
-  /* Before `vec_cast()`, which may drop names */                      \
-  SEXP names = PROTECT(slider_names(x, SLIDE));                        \
-                                                                       \
-  x = PROTECT(vec_cast(x, PTYPE));                                     \
-  const CTYPE* p_x = CONST_DEREF(x);                                   \
-                                                                       \
-  const R_xlen_t size = Rf_xlength(x);                                 \
-  const struct iter_opts iopts = new_iter_opts(opts, size);            \
-                                                                       \
-  SEXP out = PROTECT(slider_init(SEXPTYPE, size));                     \
-  CTYPE* p_out = DEREF(out);                                           \
-  Rf_setAttrib(out, R_NamesSymbol, names);                             \
-                                                                       \
-  fn(p_x, size, &iopts, na_rm, p_out);                                 \
-                                                                       \
-  UNPROTECT(3);                                                        \
-  return out;                                                          \
+/*
+ * `PTYPE` is evaluated for each `column` of `x`, see `columns.h`. Window
+ * positions only depend on the size of the columns, and `iopts` is cheap, so
+ * it is recomputed for each of them.
+ */
+#define SLIDE_SUMMARY(PTYPE, CTYPE, SEXPTYPE, DEREF) do {         \
+  SEXP out = PROTECT(columns_init(x, SEXPTYPE));                  \
+  const R_xlen_t n_columns = columns_n(x);                        \
+                                                                  \
+  for (R_xlen_t j = 0; j < n_columns; ++j) {                      \
+    SEXP column = PROTECT(columns_get(x, j));                     \
+                                                                  \
+    /* Before `vec_cast()`, which may drop names */               \
+    SEXP names = PROTECT(slider_names(column, SLIDE));            \
+                                                                  \
+    /* No deref, the tree reads ALTREP `column` in chunks */      \
+    column = PROTECT(vec_cast(column, PTYPE));                    \
+                                                                  \
+    const R_xlen_t size = Rf_xlength(column);                     \
+    const struct iter_opts iopts = new_iter_opts(opts, size);     \
+                                                                  \
+    SEXP out_column = PROTECT(slider_init(SEXPTYPE, size));       \
+    CTYPE* p_out = DEREF(out_column);                             \
+    Rf_setAttrib(out_column, R_NamesSymbol, names);               \
+                                                                  \
+    fn(column, size, &iopts, na_rm, p_out);                       \
+                                                                  \
+    columns_set(x, out, j, out_column);                           \
+    UNPROTECT(4);                                                 \
+  }                                                               \
+                                                                  \
+  out = columns_finalize(x, out);                                 \
+                                                                  \
+  UNPROTECT(1);                                                   \
+  return out;                                                     \
 } while (0)
 
 
@@ -61,91 +122,401 @@ static SEXP slide_summary_dbl(SEXP x,
                               struct slide_opts opts,
                               bool na_rm,
                               summary_impl_dbl_fn fn) {
-  SLIDE_SUMMARY(slider_shared_empty_dbl, double, REALSXP, REAL_RO, REAL);
+  SLIDE_SUMMARY(slider_shared_empty_dbl, double, REALSXP, REAL);
 }
 
 static SEXP slide_summary_lgl(SEXP x,
                               struct slide_opts opts,
                               bool na_rm,
                               summary_impl_lgl_fn fn) {
-  SLIDE_SUMMARY(slider_shared_empty_lgl, int, LGLSXP, LOGICAL_RO, LOGICAL);
+  SLIDE_SUMMARY(slider_shared_empty_lgl, int, LGLSXP, LOGICAL);
+}
+
+// Logical input, integer output
+static SEXP slide_summary_int(SEXP x,
+                              struct slide_opts opts,
+                              bool na_rm,
+                              summary_impl_int_fn fn) {
+  SLIDE_SUMMARY(slider_shared_empty_lgl, int, INTSXP, INTEGER);
+}
+
+// Like `slide_summary_dbl()`, but bare integer and logical `x` are passed
+// through as is, and `fn` is in charge of aggregating them natively
+static SEXP slide_summary_num(SEXP x,
+                              struct slide_opts opts,
+                              bool na_rm,
+                              summary_impl_dbl_fn fn) {
+  SLIDE_SUMMARY(summary_leaves_ptype(column), double, REALSXP, REAL);
+}
+
+// Positions of bare integer and logical `x` are located on the values as is
+static SEXP slide_summary_position(SEXP x,
+                                   struct slide_opts opts,
+                                   bool na_rm,
+                                   summary_impl_int_fn fn) {
+  SLIDE_SUMMARY(summary_leaves_ptype(column), int, INTSXP, INTEGER);
 }
 
 #undef SLIDE_SUMMARY
 
+// Counts don't cast `x`, they only need its size and its missing values
+static SEXP slide_summary_count(SEXP x,
+                                struct slide_opts opts,
+                                bool na_rm,
+                                summary_impl_int_fn fn) {
+  SEXP names = PROTECT(slider_names(x, SLIDE));
+
+  const R_xlen_t size = vec_size(x);
+  const struct iter_opts iopts = new_iter_opts(opts, size);
+
+  SEXP out = PROTECT(slider_init(INTSXP, size));
+  int* p_out = INTEGER(out);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  fn(x, size, &iopts, na_rm, p_out);
+
+  UNPROTECT(2);
+  return out;
+}
+
+// Like `slide_summary_count()`, with a double result
+static SEXP slide_summary_count_dbl(SEXP x,
+                                    struct slide_opts opts,
+                                    bool na_rm,
+                                    summary_impl_dbl_fn fn) {
+  SEXP names = PROTECT(slider_names(x, SLIDE));
+
+  const R_xlen_t size = vec_size(x);
+  const struct iter_opts iopts = new_iter_opts(opts, size);
+
+  SEXP out = PROTECT(slider_init(REALSXP, size));
+  double* p_out = REAL(out);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  fn(x, size, &iopts, na_rm, p_out);
+
+  UNPROTECT(2);
+  return out;
+}
+
+// Like counts, `fn` only locates a position of each window. The values of `x`
+// at those positions are sliced out afterwards, so `x` can be any vector.
+static SEXP slide_summary_slice(SEXP x,
+                                struct slide_opts opts,
+                                bool na_rm,
+                                summary_impl_int_fn fn) {
+  SEXP names = PROTECT(slider_names(x, SLIDE));
+
+  const R_xlen_t size = vec_size(x);
+  const struct iter_opts iopts = new_iter_opts(opts, size);
+
+  SEXP positions = PROTECT(slider_init(INTSXP, size));
+  int* p_positions = INTEGER(positions);
+
+  fn(x, size, &iopts, na_rm, p_positions);
+
+  SEXP out = PROTECT(vec_slice_impl(x, positions));
+  out = vec_set_names(out, names);
+
+  UNPROTECT(3);
+  return out;
+}
+
 // -----------------------------------------------------------------------------
 
-#define SLIDE_SUMMARY_LOOP(CTYPE, INIT) do {                   \
-  R_xlen_t iter_min = p_opts->iter_min;                        \
-  R_xlen_t iter_max = p_opts->iter_max;                        \
-  R_xlen_t iter_step = p_opts->iter_step;                      \
-                                                               \
-  R_xlen_t start = p_opts->start;                              \
-  R_xlen_t stop = p_opts->stop;                                \
-                                                               \
-  R_xlen_t start_stop = p_opts->start_step;                    \
-  R_xlen_t stop_step = p_opts->stop_step;                      \
-                                                               \
-  for (R_xlen_t i = iter_min; i < iter_max; i += iter_step) {  \
-    if (i % 1024 == 0) {                                       \
-      R_CheckUserInterrupt();                                  \
-    }                                                          \
-                                                               \
-    R_xlen_t window_start = max_size(start, 0);                \
-    R_xlen_t window_stop = min_size(stop + 1, p_opts->size);   \
-                                                               \
-    /* Happens when the entire window is OOB */                \
-    /* essentially take a 0-slice */                           \
-    if (window_stop < window_start) {                          \
-      window_start = 0;                                        \
-      window_stop = 0;                                         \
-    }                                                          \
-                                                               \
-    start += start_stop;                                       \
-    stop += stop_step;                                         \
-                                                               \
-    CTYPE result = INIT;                                       \
-                                                               \
-    segment_tree_aggregate(                                    \
-      p_tree,                                                  \
-      window_start,                                            \
-      window_stop,                                             \
-      &result                                                  \
-    );                                                         \
-                                                               \
-    p_out[i] = result;                                         \
-  }                                                            \
+// Rows `[begin, end)` to iterate over, the first of which is in `group`,
+// starting at `group_start`
+struct slide_range {
+  R_xlen_t begin;
+  R_xlen_t end;
+  R_xlen_t group;
+  R_xlen_t group_start;
+  bool interruptible;
+};
+
+static inline struct slide_range slide_range_all(const struct iter_opts* p_opts) {
+  return (struct slide_range) {
+    .begin = 0,
+    .end = p_opts->size,
+    .group = 0,
+    .group_start = 0,
+    .interruptible = true
+  };
+}
+
+/*
+ * When sliding by group, the rows of `x` have been reordered so that each
+ * group is contiguous. The same data structure is used across all groups, but
+ * the iterations start over at each group, and windows are clamped to the
+ * rows of the group. The bounds of the windows still never move backwards.
+ *
+ * Only the iterations of the rows of `RANGE` are run. Those before it are
+ * skipped in constant time, as the window bounds move by a fixed step.
+ */
+#define SLIDE_SUMMARY_LOOP_RANGE(RANGE, CTYPE, INIT, AGGREGATE) do {                       \
+  const struct slide_range range = RANGE;                                                  \
+  const R_xlen_t n_groups = iter_opts_n_groups(p_opts);                                    \
+                                                                                           \
+  R_xlen_t group_start = range.group_start;                                                \
+                                                                                           \
+  for (R_xlen_t group = range.group; group < n_groups && group_start < range.end; ++group) { \
+    const struct iter_opts iopts = iter_opts_group(p_opts, group);                         \
+                                                                                           \
+    R_xlen_t iter_min = iopts.iter_min;                                                    \
+    R_xlen_t iter_max = min_size(iopts.iter_max, range.end - group_start);                 \
+    R_xlen_t iter_step = iopts.iter_step;                                                  \
+                                                                                           \
+    R_xlen_t n_skip = 0;                                                                   \
+                                                                                           \
+    if (range.begin > group_start + iter_min) {                                            \
+      n_skip = (range.begin - group_start - iter_min + iter_step - 1) / iter_step;         \
+      iter_min += n_skip * iter_step;                                                      \
+    }                                                                                      \
+                                                                                           \
+    R_xlen_t start_stop = iopts.start_step;                                                \
+    R_xlen_t stop_step = iopts.stop_step;                                                  \
+                                                                                           \
+    R_xlen_t start = iopts.start + n_skip * start_stop;                                    \
+    R_xlen_t stop = iopts.stop + n_skip * stop_step;                                       \
+                                                                                           \
+    for (R_xlen_t i = iter_min; i < iter_max; i += iter_step) {                            \
+      const R_xlen_t position = group_start + i;                                           \
+                                                                                           \
+      if (range.interruptible && position % 1024 == 0) {                                   \
+        R_CheckUserInterrupt();                                                            \
+      }                                                                                    \
+                                                                                           \
+      R_xlen_t window_start = max_size(start, 0);                                          \
+      R_xlen_t window_stop = min_size(stop + 1, iopts.size);                               \
+                                                                                           \
+      /* Happens when the entire window is OOB */                                          \
+      /* essentially take a 0-slice */                                                     \
+      if (window_stop < window_start) {                                                    \
+        window_start = 0;                                                                  \
+        window_stop = 0;                                                                   \
+      }                                                                                    \
+                                                                                           \
+      window_start += group_start;                                                         \
+      window_stop += group_start;                                                          \
+                                                                                           \
+      start += start_stop;                                                                 \
+      stop += stop_step;                                                                   \
+                                                                                           \
+      CTYPE result = INIT;                                                                 \
+                                                                                           \
+      AGGREGATE;                                                                           \
+                                                                                           \
+      p_out[position] = result;                                                            \
+    }                                                                                      \
+                                                                                           \
+    group_start += iopts.size;                                                             \
+  }                                                                                        \
 } while (0)
 
+#define SLIDE_SUMMARY_LOOP(CTYPE, INIT, AGGREGATE) \
+  SLIDE_SUMMARY_LOOP_RANGE(slide_range_all(p_opts), CTYPE, INIT, AGGREGATE)
+
+
+static inline void slide_summary_loop_dbl_range(const struct segment_tree* p_tree,
+                                                void* p_state,
+                                                const struct iter_opts* p_opts,
+                                                const struct slide_range range,
+                                                double* p_out) {
+  SLIDE_SUMMARY_LOOP_RANGE(
+    range,
+    double,
+    0,
+    segment_tree_aggregate_state(p_tree, window_start, window_stop, p_state, &result)
+  );
+}
+
+struct slide_summary_chunks_dbl {
+  const struct segment_tree* p_tree;
+  union segment_tree_state* p_states;
+  const struct iter_opts* p_opts;
+  const R_xlen_t* p_group_starts;
+  double* p_out;
+};
+
+static void slide_summary_chunk_dbl(void* p_data, int thread, R_xlen_t begin, R_xlen_t end) {
+  const struct slide_summary_chunks_dbl* p_chunks = (const struct slide_summary_chunks_dbl*) p_data;
+
+  const R_xlen_t n_groups = iter_opts_n_groups(p_chunks->p_opts);
+  const R_xlen_t group = iter_opts_find_group(p_chunks->p_group_starts, n_groups, begin);
+
+  const struct slide_range range = {
+    .begin = begin,
+    .end = end,
+    .group = group,
+    .group_start = p_chunks->p_group_starts[group],
+    .interruptible = false
+  };
+
+  slide_summary_loop_dbl_range(
+    p_chunks->p_tree,
+    &p_chunks->p_states[thread],
+    p_chunks->p_opts,
+    range,
+    p_chunks->p_out
+  );
+}
 
+/*
+ * Queries of the tree are independent of each other, so with the
+ * `slider.threads` option they are spread over threads in chunks of rows,
+ * each thread with a state of its own. Chunks ignore group boundaries, so
+ * a large group is split like any other run of rows, and each chunk finds its
+ * first group by binary search.
+ */
 static inline void slide_summary_loop_dbl(const struct segment_tree* p_tree,
                                           const struct iter_opts* p_opts,
                                           double* p_out) {
-  SLIDE_SUMMARY_LOOP(double, 0);
+  const R_xlen_t size = p_opts->size;
+  const int n_threads = segment_tree_is_concurrent(p_tree) ? parallel_n_threads(size) : 1;
+
+  if (n_threads == 1) {
+    slide_summary_loop_dbl_range(p_tree, p_tree->p_state, p_opts, slide_range_all(p_opts), p_out);
+    return;
+  }
+
+  struct slide_summary_chunks_dbl chunks = {
+    .p_tree = p_tree,
+    .p_states = (union segment_tree_state*) R_alloc(n_threads, sizeof(union segment_tree_state)),
+    .p_opts = p_opts,
+    .p_group_starts = iter_opts_group_starts(p_opts),
+    .p_out = p_out
+  };
+
+  parallel_for(size, n_threads, slide_summary_chunk_dbl, &chunks);
 }
 
-static inline void slide_summary_loop_lgl(const struct segment_tree* p_tree,
-                                          const struct iter_opts* p_opts,
-                                          int* p_out) {
-  SLIDE_SUMMARY_LOOP(int, 0);
+static inline void slide_summary_loop_bitmap(const struct lgl_bitmap* p_bitmap,
+                                             const struct iter_opts* p_opts,
+                                             bool na_rm,
+                                             lgl_bitmap_summary_fn fn,
+                                             int* p_out) {
+  SLIDE_SUMMARY_LOOP(
+    int,
+    0,
+    result = fn(p_bitmap, window_start, window_stop, na_rm)
+  );
+}
+
+static inline int slide_window_n(R_xlen_t window_start, R_xlen_t window_stop) {
+  const R_xlen_t n = window_stop - window_start;
+  return n > INT_MAX ? NA_INTEGER : (int) n;
+}
+
+// Answers from the window positions alone, `x` is never touched
+static inline void slide_summary_loop_n(const struct iter_opts* p_opts,
+                                        int* p_out) {
+  SLIDE_SUMMARY_LOOP(
+    int,
+    0,
+    result = slide_window_n(window_start, window_stop)
+  );
+}
+
+// Empty windows never reach `fn`, so engines only ever see bounds that move
+// forwards
+static inline void slide_summary_loop_position(void* p_engine,
+                                               window_position_fn fn,
+                                               const struct iter_opts* p_opts,
+                                               int* p_out) {
+  SLIDE_SUMMARY_LOOP(
+    int,
+    NA_INTEGER,
+    if (window_start < window_stop) {
+      result = window_position_as_int(fn(p_engine, window_start, window_stop));
+    }
+  );
+}
+
+// Ranks the current element, rather than summarizing the window
+static inline void slide_summary_loop_rank(struct window_rank* p_rank,
+                                           const struct iter_opts* p_opts,
+                                           double* p_out) {
+  SLIDE_SUMMARY_LOOP(
+    double,
+    NA_REAL,
+    result = window_rank_locate(p_rank, window_start, window_stop, position)
+  );
+}
+
+static inline void slide_summary_loop_n_distinct(struct window_category* p_category,
+                                                const struct iter_opts* p_opts,
+                                                int* p_out) {
+  SLIDE_SUMMARY_LOOP(
+    int,
+    0,
+    if (window_start < window_stop) {
+      result = window_n_distinct(p_category, window_start, window_stop);
+    }
+  );
+}
+
+static inline void slide_summary_loop_entropy(struct window_category* p_category,
+                                              const struct iter_opts* p_opts,
+                                              double* p_out) {
+  SLIDE_SUMMARY_LOOP(
+    double,
+    NA_REAL,
+    if (window_start < window_stop) {
+      result = window_entropy(p_category, window_start, window_stop);
+    }
+  );
 }
 
 #undef SLIDE_SUMMARY_LOOP
+#undef SLIDE_SUMMARY_LOOP_RANGE
 
 // -----------------------------------------------------------------------------
 
-static inline void slide_sum_impl(const double* p_x,
+static inline void slide_sum_int_impl(SEXP x,
+                                      R_xlen_t size,
+                                      const struct iter_opts* p_opts,
+                                      bool na_rm,
+                                      double* p_out) {
+  int n_prot = 0;
+
+  int64_t state = 0;
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    sum_int_state_reset,
+    sum_int_state_finalize,
+    sum_int_nodes_increment,
+    sum_int_nodes_initialize,
+    sum_int_nodes_void_deref,
+    na_rm ? sum_int_na_rm_aggregate_from_leaves : sum_int_na_keep_aggregate_from_leaves,
+    na_rm ? sum_int_na_rm_aggregate_from_nodes : sum_int_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static inline void slide_sum_impl(SEXP x,
                                   R_xlen_t size,
                                   const struct iter_opts* p_opts,
                                   bool na_rm,
                                   double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slide_sum_int_impl(x, size, p_opts, na_rm, p_out);
+    return;
+  }
+
   int n_prot = 0;
 
   long double state = 0;
 
   struct segment_tree tree = new_segment_tree(
     size,
-    p_x,
+    x,
     &state,
     sum_state_reset,
     sum_state_finalize,
@@ -163,17 +534,17 @@ static inline void slide_sum_impl(const double* p_x,
 }
 
 static SEXP slide_sum(SEXP x, struct slide_opts opts, bool na_rm) {
-  return slide_summary_dbl(x, opts, na_rm, slide_sum_impl);
+  return slide_summary_num(x, opts, na_rm, slide_sum_impl);
 }
 
 // [[ register() ]]
-SEXP slider_sum(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm) {
-  return slider_summary(x, before, after, step, complete, na_rm, slide_sum);
+SEXP slider_sum(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_sum);
 }
 
 // -----------------------------------------------------------------------------
 
-static inline void slide_prod_impl(const double* p_x,
+static inline void slide_prod_impl(SEXP x,
                                    R_xlen_t size,
                                    const struct iter_opts* p_opts,
                                    bool na_rm,
@@ -184,7 +555,7 @@ static inline void slide_prod_impl(const double* p_x,
 
   struct segment_tree tree = new_segment_tree(
     size,
-    p_x,
+    x,
     &state,
     prod_state_reset,
     prod_state_finalize,
@@ -206,24 +577,137 @@ static SEXP slide_prod(SEXP x, struct slide_opts opts, bool na_rm) {
 }
 
 // [[ register() ]]
-SEXP slider_prod(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm) {
-  return slider_summary(x, before, after, step, complete, na_rm, slide_prod);
+SEXP slider_prod(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_prod);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_log_prod_impl(SEXP x,
+                                       R_xlen_t size,
+                                       const struct iter_opts* p_opts,
+                                       bool na_rm,
+                                       double* p_out) {
+  int n_prot = 0;
+
+  struct log_prod_state_t state;
+  log_prod_state_reset(&state);
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    log_prod_state_reset,
+    log_prod_state_finalize,
+    log_prod_nodes_increment,
+    log_prod_nodes_initialize,
+    log_prod_nodes_void_deref,
+    na_rm ? log_prod_na_rm_aggregate_from_leaves : log_prod_na_keep_aggregate_from_leaves,
+    na_rm ? log_prod_na_rm_aggregate_from_nodes : log_prod_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_log_prod(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_dbl(x, opts, na_rm, slide_log_prod_impl);
+}
+
+// [[ register() ]]
+SEXP slider_log_prod(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_log_prod);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_geomean_impl(SEXP x,
+                                      R_xlen_t size,
+                                      const struct iter_opts* p_opts,
+                                      bool na_rm,
+                                      double* p_out) {
+  int n_prot = 0;
+
+  struct log_prod_state_t state;
+  log_prod_state_reset(&state);
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    log_prod_state_reset,
+    geomean_state_finalize,
+    log_prod_nodes_increment,
+    log_prod_nodes_initialize,
+    log_prod_nodes_void_deref,
+    na_rm ? log_prod_na_rm_aggregate_from_leaves : log_prod_na_keep_aggregate_from_leaves,
+    na_rm ? log_prod_na_rm_aggregate_from_nodes : log_prod_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_geomean(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_dbl(x, opts, na_rm, slide_geomean_impl);
+}
+
+// [[ register() ]]
+SEXP slider_geomean(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_geomean);
 }
 
 // -----------------------------------------------------------------------------
 
-static inline void slide_mean_impl(const double* p_x,
+static inline void slide_mean_int_impl(SEXP x,
+                                       R_xlen_t size,
+                                       const struct iter_opts* p_opts,
+                                       bool na_rm,
+                                       double* p_out) {
+  int n_prot = 0;
+
+  struct mean_int_state_t state = { .sum = 0, .count = 0 };
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    mean_int_state_reset,
+    mean_int_state_finalize,
+    mean_int_nodes_increment,
+    mean_int_nodes_initialize,
+    mean_int_nodes_void_deref,
+    na_rm ? mean_int_na_rm_aggregate_from_leaves : mean_int_na_keep_aggregate_from_leaves,
+    na_rm ? mean_int_na_rm_aggregate_from_nodes : mean_int_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static inline void slide_mean_impl(SEXP x,
                                    R_xlen_t size,
                                    const struct iter_opts* p_opts,
                                    bool na_rm,
                                    double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slide_mean_int_impl(x, size, p_opts, na_rm, p_out);
+    return;
+  }
+
   int n_prot = 0;
 
   struct mean_state_t state = { .sum = 0, .count = 0 };
 
   struct segment_tree tree = new_segment_tree(
     size,
-    p_x,
+    x,
     &state,
     mean_state_reset,
     mean_state_finalize,
@@ -241,28 +725,141 @@ static inline void slide_mean_impl(const double* p_x,
 }
 
 static SEXP slide_mean(SEXP x, struct slide_opts opts, bool na_rm) {
-  return slide_summary_dbl(x, opts, na_rm, slide_mean_impl);
+  return slide_summary_num(x, opts, na_rm, slide_mean_impl);
+}
+
+// [[ register() ]]
+SEXP slider_mean(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_mean);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_skew_impl(SEXP x,
+                                   R_xlen_t size,
+                                   const struct iter_opts* p_opts,
+                                   bool na_rm,
+                                   double* p_out) {
+  int n_prot = 0;
+
+  struct moment_state_t state;
+  moment_state_reset(&state);
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    moment_state_reset,
+    skew_state_finalize,
+    moment_nodes_increment,
+    moment_nodes_initialize,
+    moment_nodes_void_deref,
+    na_rm ? moment_na_rm_aggregate_from_leaves : moment_na_keep_aggregate_from_leaves,
+    na_rm ? moment_na_rm_aggregate_from_nodes : moment_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_skew(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_dbl(x, opts, na_rm, slide_skew_impl);
+}
+
+// [[ register() ]]
+SEXP slider_skew(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_skew);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_kurt_impl(SEXP x,
+                                   R_xlen_t size,
+                                   const struct iter_opts* p_opts,
+                                   bool na_rm,
+                                   double* p_out) {
+  int n_prot = 0;
+
+  struct moment_state_t state;
+  moment_state_reset(&state);
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    moment_state_reset,
+    kurt_state_finalize,
+    moment_nodes_increment,
+    moment_nodes_initialize,
+    moment_nodes_void_deref,
+    na_rm ? moment_na_rm_aggregate_from_leaves : moment_na_keep_aggregate_from_leaves,
+    na_rm ? moment_na_rm_aggregate_from_nodes : moment_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_kurt(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_dbl(x, opts, na_rm, slide_kurt_impl);
 }
 
 // [[ register() ]]
-SEXP slider_mean(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm) {
-  return slider_summary(x, before, after, step, complete, na_rm, slide_mean);
+SEXP slider_kurt(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_kurt);
 }
 
 // -----------------------------------------------------------------------------
 
-static inline void slide_min_impl(const double* p_x,
+static inline void slide_min_int_impl(SEXP x,
+                                      R_xlen_t size,
+                                      const struct iter_opts* p_opts,
+                                      bool na_rm,
+                                      double* p_out) {
+  int n_prot = 0;
+
+  double state = R_PosInf;
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    min_state_reset,
+    min_state_finalize,
+    min_nodes_increment,
+    min_nodes_initialize,
+    min_nodes_void_deref,
+    na_rm ? min_int_na_rm_aggregate_from_leaves : min_int_na_keep_aggregate_from_leaves,
+    na_rm ? min_na_rm_aggregate_from_nodes : min_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static inline void slide_min_impl(SEXP x,
                                   R_xlen_t size,
                                   const struct iter_opts* p_opts,
                                   bool na_rm,
                                   double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slide_min_int_impl(x, size, p_opts, na_rm, p_out);
+    return;
+  }
+
   int n_prot = 0;
 
   double state = R_PosInf;
 
   struct segment_tree tree = new_segment_tree(
     size,
-    p_x,
+    x,
     &state,
     min_state_reset,
     min_state_finalize,
@@ -280,28 +877,61 @@ static inline void slide_min_impl(const double* p_x,
 }
 
 static SEXP slide_min(SEXP x, struct slide_opts opts, bool na_rm) {
-  return slide_summary_dbl(x, opts, na_rm, slide_min_impl);
+  return slide_summary_num(x, opts, na_rm, slide_min_impl);
 }
 
 // [[ register() ]]
-SEXP slider_min(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm) {
-  return slider_summary(x, before, after, step, complete, na_rm, slide_min);
+SEXP slider_min(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_min);
 }
 
 // -----------------------------------------------------------------------------
 
-static inline void slide_max_impl(const double* p_x,
+static inline void slide_max_int_impl(SEXP x,
+                                      R_xlen_t size,
+                                      const struct iter_opts* p_opts,
+                                      bool na_rm,
+                                      double* p_out) {
+  int n_prot = 0;
+
+  double state = R_NegInf;
+
+  struct segment_tree tree = new_segment_tree(
+    size,
+    x,
+    &state,
+    max_state_reset,
+    max_state_finalize,
+    max_nodes_increment,
+    max_nodes_initialize,
+    max_nodes_void_deref,
+    na_rm ? max_int_na_rm_aggregate_from_leaves : max_int_na_keep_aggregate_from_leaves,
+    na_rm ? max_na_rm_aggregate_from_nodes : max_na_keep_aggregate_from_nodes
+  );
+  PROTECT_SEGMENT_TREE(&tree, &n_prot);
+
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static inline void slide_max_impl(SEXP x,
                                   R_xlen_t size,
                                   const struct iter_opts* p_opts,
                                   bool na_rm,
                                   double* p_out) {
+  if (TYPEOF(x) != REALSXP) {
+    slide_max_int_impl(x, size, p_opts, na_rm, p_out);
+    return;
+  }
+
   int n_prot = 0;
 
   double state = R_NegInf;
 
   struct segment_tree tree = new_segment_tree(
     size,
-    p_x,
+    x,
     &state,
     max_state_reset,
     max_state_finalize,
@@ -319,79 +949,133 @@ static inline void slide_max_impl(const double* p_x,
 }
 
 static SEXP slide_max(SEXP x, struct slide_opts opts, bool na_rm) {
-  return slide_summary_dbl(x, opts, na_rm, slide_max_impl);
+  return slide_summary_num(x, opts, na_rm, slide_max_impl);
 }
 
 // [[ register() ]]
-SEXP slider_max(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm) {
-  return slider_summary(x, before, after, step, complete, na_rm, slide_max);
+SEXP slider_max(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_max);
 }
 
 // -----------------------------------------------------------------------------
 
-static inline void slide_all_impl(const int* p_x,
-                                  R_xlen_t size,
-                                  const struct iter_opts* p_opts,
-                                  bool na_rm,
-                                  int* p_out) {
+static inline void slide_max_drawdown_impl(SEXP x,
+                                           R_xlen_t size,
+                                           const struct iter_opts* p_opts,
+                                           bool na_rm,
+                                           double* p_out) {
   int n_prot = 0;
 
-  int state = 1;
+  struct drawdown_state_t state;
+  drawdown_state_reset(&state);
 
   struct segment_tree tree = new_segment_tree(
     size,
-    p_x,
+    x,
     &state,
-    all_state_reset,
-    all_state_finalize,
-    all_nodes_increment,
-    all_nodes_initialize,
-    all_nodes_void_deref,
-    na_rm ? all_na_rm_aggregate_from_leaves : all_na_keep_aggregate_from_leaves,
-    na_rm ? all_na_rm_aggregate_from_nodes : all_na_keep_aggregate_from_nodes
+    drawdown_state_reset,
+    drawdown_state_finalize,
+    drawdown_nodes_increment,
+    drawdown_nodes_initialize,
+    drawdown_nodes_void_deref,
+    na_rm ? drawdown_na_rm_aggregate_from_leaves : drawdown_na_keep_aggregate_from_leaves,
+    na_rm ? drawdown_na_rm_aggregate_from_nodes : drawdown_na_keep_aggregate_from_nodes
   );
   PROTECT_SEGMENT_TREE(&tree, &n_prot);
 
-  slide_summary_loop_lgl(&tree, p_opts, p_out);
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
 
   UNPROTECT(n_prot);
 }
 
-static SEXP slide_all(SEXP x, struct slide_opts opts, bool na_rm) {
-  return slide_summary_lgl(x, opts, na_rm, slide_all_impl);
+static SEXP slide_max_drawdown(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_dbl(x, opts, na_rm, slide_max_drawdown_impl);
 }
 
 // [[ register() ]]
-SEXP slider_all(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm) {
-  return slider_summary(x, before, after, step, complete, na_rm, slide_all);
+SEXP slider_max_drawdown(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_max_drawdown);
 }
 
 // -----------------------------------------------------------------------------
 
-static inline void slide_any_impl(const int* p_x,
-                                  R_xlen_t size,
-                                  const struct iter_opts* p_opts,
-                                  bool na_rm,
-                                  int* p_out) {
+static inline void slide_range_impl(SEXP x,
+                                    R_xlen_t size,
+                                    const struct iter_opts* p_opts,
+                                    bool na_rm,
+                                    double* p_out) {
   int n_prot = 0;
 
-  int state = 0;
+  struct drawdown_state_t state;
+  drawdown_state_reset(&state);
 
   struct segment_tree tree = new_segment_tree(
     size,
-    p_x,
+    x,
     &state,
-    any_state_reset,
-    any_state_finalize,
-    any_nodes_increment,
-    any_nodes_initialize,
-    any_nodes_void_deref,
-    na_rm ? any_na_rm_aggregate_from_leaves : any_na_keep_aggregate_from_leaves,
-    na_rm ? any_na_rm_aggregate_from_nodes : any_na_keep_aggregate_from_nodes
+    drawdown_state_reset,
+    range_state_finalize,
+    drawdown_nodes_increment,
+    drawdown_nodes_initialize,
+    drawdown_nodes_void_deref,
+    na_rm ? drawdown_na_rm_aggregate_from_leaves : drawdown_na_keep_aggregate_from_leaves,
+    na_rm ? drawdown_na_rm_aggregate_from_nodes : drawdown_na_keep_aggregate_from_nodes
   );
   PROTECT_SEGMENT_TREE(&tree, &n_prot);
 
-  slide_summary_loop_lgl(&tree, p_opts, p_out);
+  slide_summary_loop_dbl(&tree, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_range(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_dbl(x, opts, na_rm, slide_range_impl);
+}
+
+// [[ register() ]]
+SEXP slider_range(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_range);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_all_impl(SEXP x,
+                                  R_xlen_t size,
+                                  const struct iter_opts* p_opts,
+                                  bool na_rm,
+                                  int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_lgl_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_summary_loop_bitmap(&bitmap, p_opts, na_rm, lgl_bitmap_all, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_all(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_lgl(x, opts, na_rm, slide_all_impl);
+}
+
+// [[ register() ]]
+SEXP slider_all(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_all);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_any_impl(SEXP x,
+                                  R_xlen_t size,
+                                  const struct iter_opts* p_opts,
+                                  bool na_rm,
+                                  int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_lgl_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_summary_loop_bitmap(&bitmap, p_opts, na_rm, lgl_bitmap_any, p_out);
 
   UNPROTECT(n_prot);
 }
@@ -401,6 +1085,315 @@ static SEXP slide_any(SEXP x, struct slide_opts opts, bool na_rm) {
 }
 
 // [[ register() ]]
-SEXP slider_any(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm) {
-  return slider_summary(x, before, after, step, complete, na_rm, slide_any);
+SEXP slider_any(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_any);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_count_true_impl(SEXP x,
+                                         R_xlen_t size,
+                                         const struct iter_opts* p_opts,
+                                         bool na_rm,
+                                         int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_lgl_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_summary_loop_bitmap(&bitmap, p_opts, na_rm, lgl_bitmap_count, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_count_true(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_int(x, opts, na_rm, slide_count_true_impl);
+}
+
+// [[ register() ]]
+SEXP slider_count_true(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_count_true);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_n_impl(SEXP x,
+                                R_xlen_t size,
+                                const struct iter_opts* p_opts,
+                                bool na_rm,
+                                int* p_out) {
+  if (!na_rm) {
+    slide_summary_loop_n(p_opts, p_out);
+    return;
+  }
+
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_summary_loop_bitmap(&bitmap, p_opts, na_rm, lgl_bitmap_n_complete, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_n(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_count(x, opts, na_rm, slide_n_impl);
+}
+
+// [[ register() ]]
+SEXP slider_n(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_n);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_n_na_impl(SEXP x,
+                                   R_xlen_t size,
+                                   const struct iter_opts* p_opts,
+                                   bool na_rm,
+                                   int* p_out) {
+  int n_prot = 0;
+
+  struct lgl_bitmap bitmap = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&bitmap, &n_prot);
+
+  slide_summary_loop_bitmap(&bitmap, p_opts, na_rm, lgl_bitmap_n_missing, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_n_na(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_count(x, opts, na_rm, slide_n_na_impl);
+}
+
+// [[ register() ]]
+SEXP slider_n_na(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP by) {
+  bool dot = false;
+  struct slide_opts opts = new_slide_opts(before, after, step, complete, dot);
+  return slide_summary_by(x, opts, false, by, slide_n_na);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_first_impl(SEXP x,
+                                    R_xlen_t size,
+                                    const struct iter_opts* p_opts,
+                                    bool na_rm,
+                                    int* p_out) {
+  if (!na_rm) {
+    slide_summary_loop_position(NULL, window_first, p_opts, p_out);
+    return;
+  }
+
+  int n_prot = 0;
+
+  struct lgl_bitmap missing = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&missing, &n_prot);
+
+  struct first_complete_cursor cursor = new_first_complete_cursor(&missing);
+
+  slide_summary_loop_position(&cursor, window_first_complete, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_first(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_slice(x, opts, na_rm, slide_first_impl);
+}
+
+// [[ register() ]]
+SEXP slider_first(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_first);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_last_impl(SEXP x,
+                                   R_xlen_t size,
+                                   const struct iter_opts* p_opts,
+                                   bool na_rm,
+                                   int* p_out) {
+  if (!na_rm) {
+    slide_summary_loop_position(NULL, window_last, p_opts, p_out);
+    return;
+  }
+
+  int n_prot = 0;
+
+  struct lgl_bitmap missing = new_missing_bitmap(x);
+  PROTECT_LGL_BITMAP(&missing, &n_prot);
+
+  struct last_complete_cursor cursor = new_last_complete_cursor(&missing);
+
+  slide_summary_loop_position(&cursor, window_last_complete, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_last(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_slice(x, opts, na_rm, slide_last_impl);
+}
+
+// [[ register() ]]
+SEXP slider_last(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_last);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_which_min_impl(SEXP x,
+                                        R_xlen_t size,
+                                        const struct iter_opts* p_opts,
+                                        bool na_rm,
+                                        int* p_out) {
+  int n_prot = 0;
+
+  struct wedge wedge = new_wedge(x, false, na_rm);
+  PROTECT_WEDGE(&wedge, &n_prot);
+
+  slide_summary_loop_position(&wedge, wedge_locate, p_opts, p_out);
+  iter_opts_locate(p_opts, p_out, size);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_which_min(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_position(x, opts, na_rm, slide_which_min_impl);
+}
+
+// [[ register() ]]
+SEXP slider_which_min(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_which_min);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_which_max_impl(SEXP x,
+                                        R_xlen_t size,
+                                        const struct iter_opts* p_opts,
+                                        bool na_rm,
+                                        int* p_out) {
+  int n_prot = 0;
+
+  struct wedge wedge = new_wedge(x, true, na_rm);
+  PROTECT_WEDGE(&wedge, &n_prot);
+
+  slide_summary_loop_position(&wedge, wedge_locate, p_opts, p_out);
+  iter_opts_locate(p_opts, p_out, size);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_which_max(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_position(x, opts, na_rm, slide_which_max_impl);
+}
+
+// [[ register() ]]
+SEXP slider_which_max(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_which_max);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_rank_impl(SEXP x,
+                                   R_xlen_t size,
+                                   const struct iter_opts* p_opts,
+                                   bool na_rm,
+                                   double* p_out) {
+  int n_prot = 0;
+
+  struct window_rank rank = new_window_rank(x, na_rm, false);
+  PROTECT_WINDOW_RANK(&rank, &n_prot);
+
+  slide_summary_loop_rank(&rank, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_rank(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_dbl(x, opts, na_rm, slide_rank_impl);
+}
+
+// [[ register() ]]
+SEXP slider_rank(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_rank);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_n_distinct_impl(SEXP x,
+                                         R_xlen_t size,
+                                         const struct iter_opts* p_opts,
+                                         bool na_rm,
+                                         int* p_out) {
+  int n_prot = 0;
+
+  struct window_category category = new_window_category(x, na_rm, false);
+  PROTECT_WINDOW_CATEGORY(&category, &n_prot);
+
+  slide_summary_loop_n_distinct(&category, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_n_distinct(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_count(x, opts, na_rm, slide_n_distinct_impl);
+}
+
+// [[ register() ]]
+SEXP slider_n_distinct(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_n_distinct);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_mode_impl(SEXP x,
+                                   R_xlen_t size,
+                                   const struct iter_opts* p_opts,
+                                   bool na_rm,
+                                   int* p_out) {
+  int n_prot = 0;
+
+  struct window_category category = new_window_category(x, na_rm, true);
+  PROTECT_WINDOW_CATEGORY(&category, &n_prot);
+
+  slide_summary_loop_position(&category, window_mode, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_mode(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_slice(x, opts, na_rm, slide_mode_impl);
+}
+
+// [[ register() ]]
+SEXP slider_mode(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_mode);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void slide_entropy_impl(SEXP x,
+                                      R_xlen_t size,
+                                      const struct iter_opts* p_opts,
+                                      bool na_rm,
+                                      double* p_out) {
+  int n_prot = 0;
+
+  struct window_category category = new_window_category(x, na_rm, false);
+  PROTECT_WINDOW_CATEGORY(&category, &n_prot);
+
+  slide_summary_loop_entropy(&category, p_opts, p_out);
+
+  UNPROTECT(n_prot);
+}
+
+static SEXP slide_entropy(SEXP x, struct slide_opts opts, bool na_rm) {
+  return slide_summary_count_dbl(x, opts, na_rm, slide_entropy_impl);
+}
+
+// [[ register() ]]
+SEXP slider_entropy(SEXP x, SEXP before, SEXP after, SEXP step, SEXP complete, SEXP na_rm, SEXP by) {
+  return slider_summary(x, before, after, step, complete, na_rm, by, slide_entropy);
 }
@@ -7,6 +7,10 @@ SEXP strings_after = NULL;
 SEXP strings_step = NULL;
 SEXP strings_complete = NULL;
 SEXP strings_na_rm = NULL;
+SEXP strings_half_life = NULL;
+SEXP strings_constant = NULL;
+SEXP strings_k = NULL;
+SEXP strings_trim = NULL;
 SEXP strings_dot_before = NULL;
 SEXP strings_dot_after = NULL;
 SEXP strings_dot_step = NULL;
@@ -75,6 +79,46 @@ void stop_not_all_size_one(int iteration, int size) {
 
 // -----------------------------------------------------------------------------
 
+SEXP slider_vec_equal_na(SEXP x) {
+  SEXP call = PROTECT(Rf_lang2(Rf_install("vec_equal_na"), x));
+  SEXP out = Rf_eval(call, slider_ns_env);
+  UNPROTECT(1);
+  return out;
+}
+
+SEXP slider_vec_group_id(SEXP x) {
+  SEXP call = PROTECT(Rf_lang2(Rf_install("vec_group_id"), x));
+  SEXP out = Rf_eval(call, slider_ns_env);
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+// Bare atomic vectors, along with 1-D arrays, whose elements can be read
+// directly rather than going through vctrs
+bool is_bare_vector(SEXP x) {
+  if (OBJECT(x)) {
+    return false;
+  }
+
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP:
+  case CPLXSXP:
+  case STRSXP:
+  case RAWSXP: break;
+  default: return false;
+  }
+
+  // Matrices and arrays are sliced along their rows
+  SEXP dim = Rf_getAttrib(x, R_DimSymbol);
+  return dim == R_NilValue || Rf_xlength(dim) == 1;
+}
+
+// -----------------------------------------------------------------------------
+
 static void stop_slide_start_past_stop(SEXP starts, SEXP stops) {
   SEXP call = PROTECT(
     Rf_lang3(
@@ -159,6 +203,38 @@ SEXP slider_names(SEXP x, int type) {
 
 // -----------------------------------------------------------------------------
 
+size_t r_vec_elt_size(SEXP x) {
+  switch (TYPEOF(x)) {
+  case LGLSXP: return sizeof(int);
+  case INTSXP: return sizeof(int);
+  case REALSXP: return sizeof(double);
+  default: never_reached("r_vec_elt_size");
+  }
+}
+
+// Copies `n` elements of `x` starting at `i` into `p_buf`. For ALTREP vectors
+// this goes through the class's `Get_region()` method, so nothing beyond the
+// requested region is materialized.
+void r_vec_get_region(SEXP x, R_xlen_t i, R_xlen_t n, void* p_buf) {
+#if (R_VERSION >= R_Version(3, 5, 0))
+  switch (TYPEOF(x)) {
+  case LGLSXP: LOGICAL_GET_REGION(x, i, n, (int*) p_buf); return;
+  case INTSXP: INTEGER_GET_REGION(x, i, n, (int*) p_buf); return;
+  case REALSXP: REAL_GET_REGION(x, i, n, (double*) p_buf); return;
+  default: never_reached("r_vec_get_region");
+  }
+#else
+  switch (TYPEOF(x)) {
+  case LGLSXP: memcpy(p_buf, LOGICAL(x) + i, n * sizeof(int)); return;
+  case INTSXP: memcpy(p_buf, INTEGER(x) + i, n * sizeof(int)); return;
+  case REALSXP: memcpy(p_buf, REAL(x) + i, n * sizeof(double)); return;
+  default: never_reached("r_vec_get_region");
+  }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+
 // `slice_and_update_env()` works by repeatedly overwriting the
 // `container` with the results of slicing into `x`. This is mainly important
 // for performance with `pslide()`, where `container` is a list the same size
@@ -248,6 +324,22 @@ void slider_initialize_utils(SEXP ns) {
   R_PreserveObject(strings_na_rm);
   SET_STRING_ELT(strings_na_rm, 0, Rf_mkChar("na_rm"));
 
+  strings_half_life = Rf_allocVector(STRSXP, 1);
+  R_PreserveObject(strings_half_life);
+  SET_STRING_ELT(strings_half_life, 0, Rf_mkChar("half_life"));
+
+  strings_constant = Rf_allocVector(STRSXP, 1);
+  R_PreserveObject(strings_constant);
+  SET_STRING_ELT(strings_constant, 0, Rf_mkChar("constant"));
+
+  strings_k = Rf_allocVector(STRSXP, 1);
+  R_PreserveObject(strings_k);
+  SET_STRING_ELT(strings_k, 0, Rf_mkChar("k"));
+
+  strings_trim = Rf_allocVector(STRSXP, 1);
+  R_PreserveObject(strings_trim);
+  SET_STRING_ELT(strings_trim, 0, Rf_mkChar("trim"));
+
   strings_dot_before = Rf_allocVector(STRSXP, 1);
   R_PreserveObject(strings_dot_before);
   SET_STRING_ELT(strings_dot_before, 0, Rf_mkChar(".before"));
@@ -33,6 +33,22 @@ static inline SEXP r_force_eval(SEXP call, SEXP env, const int n_force) {
 #endif
 }
 
+// Unlike `REAL_RO()` and friends, this doesn't force ALTREP vectors to
+// materialize. Returns `NULL` if there is no contiguous data pointer, in which
+// case data must be pulled with `r_vec_get_region()`.
+static inline const void* r_vec_deref_or_null(SEXP x) {
+#if (R_VERSION >= R_Version(3, 5, 0))
+  return DATAPTR_OR_NULL(x);
+#else
+  switch (TYPEOF(x)) {
+  case LGLSXP: return (const void*) LOGICAL(x);
+  case INTSXP: return (const void*) INTEGER(x);
+  case REALSXP: return (const void*) REAL(x);
+  default: return NULL;
+  }
+#endif
+}
+
 static inline SEXP r_lst_get(SEXP x, int i) {
   return VECTOR_ELT(x, i);
 }
@@ -67,6 +83,10 @@ extern SEXP strings_after;
 extern SEXP strings_step;
 extern SEXP strings_complete;
 extern SEXP strings_na_rm;
+extern SEXP strings_half_life;
+extern SEXP strings_constant;
+extern SEXP strings_k;
+extern SEXP strings_trim;
 extern SEXP strings_dot_before;
 extern SEXP strings_dot_after;
 extern SEXP strings_dot_step;
@@ -89,6 +109,11 @@ SEXP slider_init(SEXPTYPE type, R_xlen_t size);
 
 void stop_not_all_size_one(int iteration, int size);
 
+SEXP slider_vec_equal_na(SEXP x);
+SEXP slider_vec_group_id(SEXP x);
+
+bool is_bare_vector(SEXP x);
+
 void check_slide_starts_not_past_stops(SEXP starts,
                                        SEXP stops,
                                        const int* p_starts,
@@ -105,6 +130,9 @@ int compute_force(int type);
 
 SEXP slider_names(SEXP x, int type);
 
+size_t r_vec_elt_size(SEXP x);
+void r_vec_get_region(SEXP x, R_xlen_t i, R_xlen_t n, void* p_buf);
+
 SEXP make_slice_container(int type);
 void slice_and_update_env(SEXP x, SEXP window, SEXP env, int type, SEXP container);
 
@@ -0,0 +1,447 @@
+#include "window-category.h"
+#include "slider-vctrs.h"
+#include "utils.h"
+#include "align.h"
+
+// Number of elements pulled at once when `x` doesn't have a data pointer
+// (i.e. unmaterialized ALTREP vectors)
+#define CATEGORY_CHUNK_SIZE 4096
+
+#define CATEGORY_TABLE_INITIAL_CAPACITY 256
+
+static SEXP category_codes(SEXP x, int* p_n_codes);
+
+// [[ include("window-category.h") ]]
+struct window_category new_window_category(SEXP x, bool na_rm, bool mode) {
+  struct window_category category;
+
+  int n_codes = 0;
+  category.codes = PROTECT(category_codes(x, &n_codes));
+  category.p_codes = INTEGER_RO(category.codes);
+  category.n_codes = n_codes;
+
+  int n_leaves = 1;
+  if (mode) {
+    while (n_leaves < n_codes) {
+      n_leaves *= 2;
+    }
+  }
+  category.n_leaves = n_leaves;
+
+  // Counts, then positions and the tree nodes for the mode
+  const R_xlen_t n_xlen = mode ? 2 * (R_xlen_t) n_codes : n_codes;
+  const R_xlen_t n_int = mode ? 2 * (R_xlen_t) n_leaves : 0;
+
+  category.data = PROTECT(aligned_allocate(
+    n_xlen + n_int / 2 + 1,
+    sizeof(R_xlen_t),
+    sizeof(R_xlen_t)
+  ));
+
+  R_xlen_t* p_data = (R_xlen_t*) aligned_void_deref(category.data, sizeof(R_xlen_t));
+
+  category.p_counts = p_data;
+  memset(category.p_counts, 0, n_codes * sizeof(R_xlen_t));
+
+  category.p_positions = NULL;
+  category.p_tree = NULL;
+
+  if (mode) {
+    category.p_positions = p_data + n_codes;
+    category.p_tree = (int*) (p_data + n_xlen);
+
+    // With every count at zero, each node holds the smallest code below it
+    int* p_tree = category.p_tree;
+
+    for (int i = 0; i < n_leaves; ++i) {
+      p_tree[n_leaves + i] = i < n_codes ? i : -1;
+    }
+    for (int i = n_leaves - 1; i > 0; --i) {
+      p_tree[i] = p_tree[2 * i] >= 0 ? p_tree[2 * i] : p_tree[2 * i + 1];
+    }
+  }
+
+  category.begin = 0;
+  category.end = 0;
+  category.n = 0;
+  category.n_missing = 0;
+  category.n_distinct = 0;
+  category.entropy_sum = 0;
+  category.na_rm = na_rm;
+  category.mode = mode;
+
+  UNPROTECT(2);
+  return category;
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * An open addressing hash table from keys to the codes handed out in order of
+ * first appearance. It doubles in size whenever it gets half full, so it only
+ * grows with the number of distinct values.
+ */
+struct category_table {
+  SEXP data;
+  PROTECT_INDEX data_pi;
+  uint64_t* p_keys;
+  int* p_codes;
+  R_xlen_t capacity;
+  int shift;
+  int n;
+};
+
+static void category_table_set_data(struct category_table* p_table, SEXP data, R_xlen_t capacity) {
+  p_table->p_keys = (uint64_t*) aligned_void_deref(data, sizeof(uint64_t));
+  p_table->p_codes = (int*) (p_table->p_keys + capacity);
+  p_table->capacity = capacity;
+
+  for (R_xlen_t i = 0; i < capacity; ++i) {
+    p_table->p_codes[i] = -1;
+  }
+}
+
+static SEXP category_table_allocate(R_xlen_t capacity) {
+  return aligned_allocate(capacity, sizeof(uint64_t) + sizeof(int), sizeof(uint64_t));
+}
+
+static inline R_xlen_t category_table_slot(const struct category_table* p_table, uint64_t key) {
+  // Fibonacci hashing, keeping the top bits of the product
+  return (R_xlen_t) ((key * UINT64_C(0x9E3779B97F4A7C15)) >> p_table->shift);
+}
+
+static void category_table_insert(struct category_table* p_table, uint64_t key, int code) {
+  const R_xlen_t mask = p_table->capacity - 1;
+  R_xlen_t slot = category_table_slot(p_table, key);
+
+  while (p_table->p_codes[slot] >= 0) {
+    slot = (slot + 1) & mask;
+  }
+
+  p_table->p_keys[slot] = key;
+  p_table->p_codes[slot] = code;
+}
+
+static void category_table_grow(struct category_table* p_table) {
+  const R_xlen_t old_capacity = p_table->capacity;
+  const uint64_t* p_old_keys = p_table->p_keys;
+  const int* p_old_codes = p_table->p_codes;
+
+  // Keep the old table alive while it is rehashed
+  PROTECT(p_table->data);
+
+  const R_xlen_t capacity = old_capacity * 2;
+  SEXP data = category_table_allocate(capacity);
+  REPROTECT(p_table->data = data, p_table->data_pi);
+
+  category_table_set_data(p_table, data, capacity);
+  --p_table->shift;
+
+  for (R_xlen_t i = 0; i < old_capacity; ++i) {
+    if (p_old_codes[i] >= 0) {
+      category_table_insert(p_table, p_old_keys[i], p_old_codes[i]);
+    }
+  }
+
+  UNPROTECT(1);
+}
+
+static int category_table_code(struct category_table* p_table, uint64_t key) {
+  const R_xlen_t mask = p_table->capacity - 1;
+  R_xlen_t slot = category_table_slot(p_table, key);
+
+  while (p_table->p_codes[slot] >= 0) {
+    if (p_table->p_keys[slot] == key) {
+      return p_table->p_codes[slot];
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  const int code = p_table->n;
+  ++p_table->n;
+
+  p_table->p_keys[slot] = key;
+  p_table->p_codes[slot] = code;
+
+  if (2 * (R_xlen_t) p_table->n > p_table->capacity) {
+    category_table_grow(p_table);
+  }
+
+  return code;
+}
+
+static inline uint64_t category_int_key(int x) {
+  return (uint64_t) (uint32_t) x;
+}
+
+static inline uint64_t category_dbl_key(double x) {
+  // `-0` and `0` are the same category
+  if (x == 0) {
+    x = 0;
+  }
+  uint64_t out;
+  memcpy(&out, &x, sizeof(double));
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+static void category_codes_factor(SEXP x, R_xlen_t size, int* p_out) {
+  for (R_xlen_t i = 0; i < size; i += CATEGORY_CHUNK_SIZE) {
+    const R_xlen_t n = min_size(size - i, CATEGORY_CHUNK_SIZE);
+    int* p_chunk = p_out + i;
+
+    r_vec_get_region(x, i, n, p_chunk);
+
+    for (R_xlen_t j = 0; j < n; ++j) {
+      p_chunk[j] = p_chunk[j] == NA_INTEGER ? -1 : p_chunk[j] - 1;
+    }
+  }
+}
+
+static void category_codes_hash(SEXP x, R_xlen_t size, int* p_out, int* p_n_codes) {
+  int n_prot = 0;
+
+  struct category_table table;
+  table.data = category_table_allocate(CATEGORY_TABLE_INITIAL_CAPACITY);
+  PROTECT_WITH_INDEX(table.data, &table.data_pi);
+  ++n_prot;
+  category_table_set_data(&table, table.data, CATEGORY_TABLE_INITIAL_CAPACITY);
+  table.shift = 64 - 8;
+  table.n = 0;
+
+  const SEXPTYPE type = TYPEOF(x);
+
+  double* p_buffer = NULL;
+  if (type == REALSXP) {
+    p_buffer = REAL(PROTECT_N(Rf_allocVector(REALSXP, CATEGORY_CHUNK_SIZE), &n_prot));
+  }
+
+  for (R_xlen_t i = 0; i < size; i += CATEGORY_CHUNK_SIZE) {
+    R_CheckUserInterrupt();
+
+    const R_xlen_t n = min_size(size - i, CATEGORY_CHUNK_SIZE);
+    int* p_chunk = p_out + i;
+
+    switch (type) {
+    case LGLSXP:
+    case INTSXP: {
+      // Read in place, each value is replaced by its code
+      r_vec_get_region(x, i, n, p_chunk);
+
+      for (R_xlen_t j = 0; j < n; ++j) {
+        const int elt = p_chunk[j];
+        p_chunk[j] = elt == NA_INTEGER ? -1 : category_table_code(&table, category_int_key(elt));
+      }
+      break;
+    }
+    case REALSXP: {
+      r_vec_get_region(x, i, n, p_buffer);
+
+      for (R_xlen_t j = 0; j < n; ++j) {
+        const double elt = p_buffer[j];
+        p_chunk[j] = isnan(elt) ? -1 : category_table_code(&table, category_dbl_key(elt));
+      }
+      break;
+    }
+    case STRSXP: {
+      // Strings are compared by address. The same string in two different
+      // encodings is two different categories.
+      for (R_xlen_t j = 0; j < n; ++j) {
+        SEXP elt = STRING_ELT(x, i + j);
+        p_chunk[j] = elt == NA_STRING ? -1 : category_table_code(&table, (uint64_t) (uintptr_t) elt);
+      }
+      break;
+    }
+    default: never_reached("category_codes_hash");
+    }
+  }
+
+  *p_n_codes = table.n;
+
+  UNPROTECT(n_prot);
+}
+
+// Codes from `vec_group_id()` count the missing group, which is left unused
+static void category_codes_vctrs(SEXP x, R_xlen_t size, int* p_out, int* p_n_codes) {
+  SEXP group_id = PROTECT(slider_vec_group_id(x));
+  SEXP missing = PROTECT(slider_vec_equal_na(x));
+
+  const int* p_group_id = INTEGER_RO(group_id);
+  const int* p_missing = LOGICAL_RO(missing);
+
+  int n_codes = 0;
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    const int code = p_group_id[i];
+    n_codes = code > n_codes ? code : n_codes;
+    p_out[i] = p_missing[i] ? -1 : code - 1;
+  }
+
+  *p_n_codes = n_codes;
+
+  UNPROTECT(2);
+}
+
+static SEXP category_codes(SEXP x, int* p_n_codes) {
+  const R_xlen_t size = vec_size(x);
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, size));
+  int* p_out = INTEGER(out);
+
+  if (Rf_inherits(x, "factor")) {
+    category_codes_factor(x, size, p_out);
+    *p_n_codes = Rf_length(Rf_getAttrib(x, R_LevelsSymbol));
+  } else if (is_bare_vector(x) && TYPEOF(x) != CPLXSXP && TYPEOF(x) != RAWSXP) {
+    category_codes_hash(x, size, p_out, p_n_codes);
+  } else {
+    category_codes_vctrs(x, size, p_out, p_n_codes);
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+static inline long double x_log_x(R_xlen_t x) {
+  return x == 0 ? 0 : x * logl((long double) x);
+}
+
+// The node keeps the more frequent code of its children, the left one on ties
+static inline void category_tree_update(struct window_category* p_category, int code) {
+  int* p_tree = p_category->p_tree;
+  const R_xlen_t* p_counts = p_category->p_counts;
+
+  for (int i = (p_category->n_leaves + code) / 2; i > 0; i /= 2) {
+    const int left = p_tree[2 * i];
+    const int right = p_tree[2 * i + 1];
+
+    if (right < 0 || (left >= 0 && p_counts[left] >= p_counts[right])) {
+      p_tree[i] = left;
+    } else {
+      p_tree[i] = right;
+    }
+  }
+}
+
+static inline void category_add(struct window_category* p_category, R_xlen_t position) {
+  const int code = p_category->p_codes[position];
+
+  if (code < 0) {
+    ++p_category->n_missing;
+    return;
+  }
+
+  const R_xlen_t count = p_category->p_counts[code];
+
+  if (count == 0) {
+    ++p_category->n_distinct;
+  }
+
+  p_category->entropy_sum += x_log_x(count + 1) - x_log_x(count);
+  p_category->p_counts[code] = count + 1;
+  ++p_category->n;
+
+  if (p_category->mode) {
+    // The last added element of a category is the last one to leave
+    p_category->p_positions[code] = position;
+    category_tree_update(p_category, code);
+  }
+}
+
+static inline void category_remove(struct window_category* p_category, R_xlen_t position) {
+  const int code = p_category->p_codes[position];
+
+  if (code < 0) {
+    --p_category->n_missing;
+    return;
+  }
+
+  const R_xlen_t count = p_category->p_counts[code];
+
+  if (count == 1) {
+    --p_category->n_distinct;
+  }
+
+  p_category->entropy_sum += x_log_x(count - 1) - x_log_x(count);
+  p_category->p_counts[code] = count - 1;
+  --p_category->n;
+
+  if (p_category->mode) {
+    category_tree_update(p_category, code);
+  }
+}
+
+static inline void category_slide(struct window_category* p_category, R_xlen_t begin, R_xlen_t end) {
+  while (p_category->end < end) {
+    category_add(p_category, p_category->end);
+    ++p_category->end;
+  }
+
+  while (p_category->begin < begin) {
+    category_remove(p_category, p_category->begin);
+    ++p_category->begin;
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+// Like `length(unique(x))`, missing values count as one more value unless
+// they are removed
+// [[ include("window-category.h") ]]
+int window_n_distinct(struct window_category* p_category, R_xlen_t begin, R_xlen_t end) {
+  category_slide(p_category, begin, end);
+
+  R_xlen_t out = p_category->n_distinct;
+
+  if (!p_category->na_rm && p_category->n_missing > 0) {
+    ++out;
+  }
+
+  return out > INT_MAX ? NA_INTEGER : (int) out;
+}
+
+// Shannon entropy in nats, `log(n) - sum(count * log(count)) / n`
+// [[ include("window-category.h") ]]
+double window_entropy(struct window_category* p_category, R_xlen_t begin, R_xlen_t end) {
+  category_slide(p_category, begin, end);
+
+  if (!p_category->na_rm && p_category->n_missing > 0) {
+    return NA_REAL;
+  }
+
+  const R_xlen_t n = p_category->n;
+
+  if (n == 0) {
+    return NA_REAL;
+  }
+
+  // Exact, rather than subject to the rounding of the running sum
+  if (p_category->n_distinct == 1) {
+    return 0;
+  }
+
+  const long double out = logl((long double) n) - p_category->entropy_sum / n;
+
+  return out < 0 ? 0 : (double) out;
+}
+
+// [[ include("window-category.h") ]]
+R_xlen_t window_mode(void* p_category, R_xlen_t begin, R_xlen_t end) {
+  struct window_category* p_category_ = (struct window_category*) p_category;
+
+  category_slide(p_category_, begin, end);
+
+  if (!p_category_->na_rm && p_category_->n_missing > 0) {
+    return -1;
+  }
+
+  if (p_category_->n == 0) {
+    return -1;
+  }
+
+  const int code = p_category_->p_tree[1];
+
+  return p_category_->p_positions[code];
+}
@@ -0,0 +1,60 @@
+#ifndef SLIDER_WINDOW_CATEGORY
+#define SLIDER_WINDOW_CATEGORY
+
+#include "slider.h"
+
+/*
+ * A frequency table of the categories in the current window.
+ *
+ * Every element of `x` is first mapped to an integer code, `-1` marking
+ * missing values. Factors use their codes as is. Bare logical, integer,
+ * double, and character vectors are hashed once, strings by the address of
+ * their CHARSXP, which R's global string cache makes unique. Anything else
+ * goes through `vec_group_id()`.
+ *
+ * The window only moves forwards, see `window-position.h`. Each element is
+ * added and removed once, updating the number of distinct categories and the
+ * entropy in constant time.
+ *
+ * The mode is only tracked when requested. A max tree over the codes keeps
+ * the most frequent one at its root, ties going to the smallest code. It
+ * costs `O(log(n_codes))` per element.
+ */
+struct window_category {
+  SEXP codes;
+  const int* p_codes;
+  int n_codes;
+
+  SEXP data;
+  R_xlen_t* p_counts;
+  R_xlen_t* p_positions;
+  int* p_tree;
+  int n_leaves;
+
+  R_xlen_t begin;
+  R_xlen_t end;
+
+  R_xlen_t n;
+  R_xlen_t n_missing;
+  R_xlen_t n_distinct;
+
+  // Sum of `count * log(count)` over the categories in the window
+  long double entropy_sum;
+
+  bool na_rm;
+  bool mode;
+};
+
+#define PROTECT_WINDOW_CATEGORY(p_category, p_n) do {  \
+  PROTECT((p_category)->codes);                        \
+  PROTECT((p_category)->data);                         \
+  *(p_n) += 2;                                         \
+} while(0)
+
+struct window_category new_window_category(SEXP x, bool na_rm, bool mode);
+
+int window_n_distinct(struct window_category* p_category, R_xlen_t begin, R_xlen_t end);
+double window_entropy(struct window_category* p_category, R_xlen_t begin, R_xlen_t end);
+R_xlen_t window_mode(void* p_category, R_xlen_t begin, R_xlen_t end);
+
+#endif
@@ -0,0 +1,344 @@
+#include "window-lm.h"
+#include "utils.h"
+
+/*
+ * Predictors whose pivot in the Cholesky factorization of the co-moments
+ * falls below this fraction of their own co-moment are treated as collinear
+ * with the others. It is the square of a tolerance of `1e-6` on the pivots of
+ * a QR decomposition of the centered predictors.
+ */
+#define LM_SINGULAR_TOLERANCE 1e-12
+
+/*
+ * The statistics of `n_vars` variables take `stride` doubles: the number of
+ * observations, the `n_vars` means, and the upper triangle of the co-moment
+ * matrix, packed row by row.
+ */
+static inline R_xlen_t lm_tri(int n_vars, int j, int k) {
+  return 1 + n_vars + (R_xlen_t) j * n_vars - (R_xlen_t) j * (j - 1) / 2 + (k - j);
+}
+
+static inline void lm_stats_reset(double* p_stats, int stride) {
+  memset(p_stats, 0, stride * sizeof(double));
+}
+
+static inline void lm_stats_copy(double* p_dest, const double* p_source, int stride) {
+  memcpy(p_dest, p_source, stride * sizeof(double));
+}
+
+// Welford's update with a single observation
+static inline void lm_stats_push(double* p_stats, const double* p_row, int n_vars, double* p_delta) {
+  const double n = p_stats[0] + 1;
+  const double scale = (n - 1) / n;
+
+  p_stats[0] = n;
+
+  for (int j = 0; j < n_vars; ++j) {
+    p_delta[j] = p_row[j] - p_stats[1 + j];
+    p_stats[1 + j] += p_delta[j] / n;
+  }
+
+  for (int j = 0; j < n_vars; ++j) {
+    const double delta = p_delta[j] * scale;
+
+    for (int k = j; k < n_vars; ++k) {
+      p_stats[lm_tri(n_vars, j, k)] += delta * p_delta[k];
+    }
+  }
+}
+
+// Chan et al.'s pairwise update, `p_x` and `p_y` must not alias `p_dest`
+static inline void lm_stats_merge(double* p_dest,
+                                  const double* p_x,
+                                  const double* p_y,
+                                  int n_vars,
+                                  int stride,
+                                  double* p_delta) {
+  const double n_x = p_x[0];
+  const double n_y = p_y[0];
+
+  if (n_x == 0) {
+    lm_stats_copy(p_dest, p_y, stride);
+    return;
+  }
+  if (n_y == 0) {
+    lm_stats_copy(p_dest, p_x, stride);
+    return;
+  }
+
+  const double n = n_x + n_y;
+  const double scale = n_x * n_y / n;
+
+  p_dest[0] = n;
+
+  for (int j = 0; j < n_vars; ++j) {
+    p_delta[j] = p_y[1 + j] - p_x[1 + j];
+    p_dest[1 + j] = p_x[1 + j] + p_delta[j] * (n_y / n);
+  }
+
+  for (int j = 0; j < n_vars; ++j) {
+    const double delta = p_delta[j] * scale;
+
+    for (int k = j; k < n_vars; ++k) {
+      const R_xlen_t loc = lm_tri(n_vars, j, k);
+      p_dest[loc] = p_x[loc] + p_y[loc] + delta * p_delta[k];
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * `y` must be a double vector, and `x` a double matrix with as many rows as
+ * `y` has elements. Both are pulled in full once, column by column, so
+ * unmaterialized ALTREP vectors are copied but never materialized. The
+ * stacks live in `R_alloc()` memory, which is released at the end of the
+ * `.Call()`.
+ */
+// [[ include("window-lm.h") ]]
+struct window_lm new_window_lm(SEXP y, SEXP x, bool na_rm) {
+  const R_xlen_t size = Rf_xlength(y);
+  const int n_predictors = Rf_ncols(x);
+  const int n_vars = n_predictors + 1;
+  const int stride = 1 + n_vars + n_vars * (n_vars + 1) / 2;
+
+  // Column major, with `y` last
+  SEXP values = PROTECT(Rf_allocVector(REALSXP, size * n_vars));
+  double* p_values = REAL(values);
+
+  r_vec_get_region(x, 0, size * n_predictors, p_values);
+  r_vec_get_region(y, 0, size, p_values + size * n_predictors);
+
+  double* p_back = (double*) R_alloc(stride, sizeof(double));
+  lm_stats_reset(p_back, stride);
+
+  struct window_lm lm = {
+    .values = values,
+    .p_values = p_values,
+    .size = size,
+    .n_predictors = n_predictors,
+    .n_vars = n_vars,
+    .stride = stride,
+    .p_back = p_back,
+    .p_front = NULL,
+    .front_capacity = 0,
+    .p_merged = (double*) R_alloc(stride, sizeof(double)),
+    .p_row = (double*) R_alloc(2 * n_vars, sizeof(double)),
+    .p_work = (double*) R_alloc((R_xlen_t) n_predictors * n_predictors + n_predictors, sizeof(double)),
+    .base = 0,
+    .flip = 0,
+    .begin = 0,
+    .end = 0,
+    .n_missing = 0,
+    .na_rm = na_rm
+  };
+
+  UNPROTECT(1);
+  return lm;
+}
+
+// Loads row `position` into `p_row`, returning whether it has a missing value
+static inline bool window_lm_row(struct window_lm* p_lm, R_xlen_t position) {
+  const double* p_values = p_lm->p_values + position;
+  const R_xlen_t size = p_lm->size;
+  const int n_vars = p_lm->n_vars;
+
+  double* p_row = p_lm->p_row;
+  bool missing = false;
+
+  for (int j = 0; j < n_vars; ++j) {
+    const double elt = p_values[j * size];
+    missing = missing || isnan(elt);
+    p_row[j] = elt;
+  }
+
+  return missing;
+}
+
+/*
+ * Only called once the window has moved past the whole front stack, so
+ * `[begin, end)` is a suffix of the back stack. It becomes the new front
+ * stack, building the statistics of each suffix from the last element
+ * backwards.
+ */
+static void window_lm_flip(struct window_lm* p_lm) {
+  const int n_vars = p_lm->n_vars;
+  const int stride = p_lm->stride;
+
+  const R_xlen_t begin = p_lm->begin;
+  const R_xlen_t end = p_lm->end;
+  const R_xlen_t n = end - begin;
+
+  // Leaves room for the empty suffix at `end`
+  if (p_lm->front_capacity < n + 1) {
+    const R_xlen_t capacity = max_size(2 * p_lm->front_capacity, n + 1);
+    p_lm->p_front = (double*) R_alloc(capacity * stride, sizeof(double));
+    p_lm->front_capacity = capacity;
+  }
+
+  double* p_front = p_lm->p_front;
+  double* p_delta = p_lm->p_row + n_vars;
+
+  lm_stats_reset(p_front + n * stride, stride);
+
+  for (R_xlen_t k = n - 1; k >= 0; --k) {
+    double* p_stats = p_front + k * stride;
+    lm_stats_copy(p_stats, p_stats + stride, stride);
+
+    if (!window_lm_row(p_lm, begin + k)) {
+      lm_stats_push(p_stats, p_lm->p_row, n_vars, p_delta);
+    }
+  }
+
+  lm_stats_reset(p_lm->p_back, stride);
+
+  p_lm->base = begin;
+  p_lm->flip = end;
+}
+
+static void window_lm_solve(struct window_lm* p_lm, const double* p_stats, double* p_fit);
+
+// [[ include("window-lm.h") ]]
+void window_lm_fit(struct window_lm* p_lm, R_xlen_t begin, R_xlen_t end, double* p_fit) {
+  const int n_vars = p_lm->n_vars;
+  const int n_fit = WINDOW_LM_N_FIT(p_lm->n_predictors);
+
+  for (int k = 0; k < n_fit; ++k) {
+    p_fit[k] = NA_REAL;
+  }
+
+  // Empty windows leave the stacks as is, the next window picks up from the
+  // previous non-empty one
+  if (begin >= end) {
+    return;
+  }
+
+  double* p_delta = p_lm->p_row + n_vars;
+
+  while (p_lm->end < end) {
+    if (window_lm_row(p_lm, p_lm->end)) {
+      ++p_lm->n_missing;
+    } else {
+      lm_stats_push(p_lm->p_back, p_lm->p_row, n_vars, p_delta);
+    }
+    ++p_lm->end;
+  }
+
+  while (p_lm->begin < begin) {
+    p_lm->n_missing -= window_lm_row(p_lm, p_lm->begin);
+    ++p_lm->begin;
+  }
+
+  if (!p_lm->na_rm && p_lm->n_missing > 0) {
+    return;
+  }
+
+  if (p_lm->begin > p_lm->flip) {
+    window_lm_flip(p_lm);
+  }
+
+  const double* p_stats = p_lm->p_back;
+
+  if (p_lm->begin < p_lm->flip) {
+    const double* p_front = p_lm->p_front + (p_lm->begin - p_lm->base) * p_lm->stride;
+    lm_stats_merge(p_lm->p_merged, p_front, p_lm->p_back, n_vars, p_lm->stride, p_delta);
+    p_stats = p_lm->p_merged;
+  }
+
+  window_lm_solve(p_lm, p_stats, p_fit);
+}
+
+/*
+ * Solves the normal equations of the centered predictors with a Cholesky
+ * factorization of their co-moments. With `L z = Sxy` and `L' b = z`, the
+ * residual sum of squares is `Syy - z'z`.
+ *
+ * Windows with fewer observations than coefficients, or with collinear
+ * predictors, leave the whole fit missing.
+ */
+static void window_lm_solve(struct window_lm* p_lm, const double* p_stats, double* p_fit) {
+  const int p = p_lm->n_predictors;
+  const int n_vars = p_lm->n_vars;
+  const double n = p_stats[0];
+
+  if (n < p + 1) {
+    return;
+  }
+
+  double* p_chol = p_lm->p_work;
+  double* p_z = p_chol + (R_xlen_t) p * p;
+
+  for (int j = 0; j < p; ++j) {
+    const double s_jj = p_stats[lm_tri(n_vars, j, j)];
+    double pivot = s_jj;
+
+    for (int k = 0; k < j; ++k) {
+      pivot -= p_chol[j * p + k] * p_chol[j * p + k];
+    }
+
+    if (!(pivot > LM_SINGULAR_TOLERANCE * s_jj)) {
+      return;
+    }
+
+    const double l_jj = sqrt(pivot);
+    p_chol[j * p + j] = l_jj;
+
+    for (int i = j + 1; i < p; ++i) {
+      double elt = p_stats[lm_tri(n_vars, j, i)];
+
+      for (int k = 0; k < j; ++k) {
+        elt -= p_chol[i * p + k] * p_chol[j * p + k];
+      }
+
+      p_chol[i * p + j] = elt / l_jj;
+    }
+  }
+
+  // Forward substitution, `L z = Sxy`
+  long double zz = 0;
+
+  for (int j = 0; j < p; ++j) {
+    double elt = p_stats[lm_tri(n_vars, j, p)];
+
+    for (int k = 0; k < j; ++k) {
+      elt -= p_chol[j * p + k] * p_z[k];
+    }
+
+    p_z[j] = elt / p_chol[j * p + j];
+    zz += (long double) p_z[j] * p_z[j];
+  }
+
+  // Backward substitution, `L' b = z`, in place
+  for (int j = p - 1; j >= 0; --j) {
+    double elt = p_z[j];
+
+    for (int k = j + 1; k < p; ++k) {
+      elt -= p_chol[k * p + j] * p_z[k];
+    }
+
+    p_z[j] = elt / p_chol[j * p + j];
+  }
+
+  const double* p_means = p_stats + 1;
+  double intercept = p_means[p];
+
+  for (int j = 0; j < p; ++j) {
+    intercept -= p_z[j] * p_means[j];
+    p_fit[1 + j] = p_z[j];
+  }
+
+  p_fit[0] = intercept;
+
+  const double syy = p_stats[lm_tri(n_vars, p, p)];
+  const double rss = fmax((double) (syy - zz), 0);
+
+  if (syy > 0) {
+    p_fit[p + 1] = 1 - rss / syy;
+  }
+
+  const double df = n - p - 1;
+
+  if (df > 0) {
+    p_fit[p + 2] = sqrt(rss / df);
+  }
+}
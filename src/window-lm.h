@@ -0,0 +1,70 @@
+#ifndef SLIDER_WINDOW_LM
+#define SLIDER_WINDOW_LM
+
+#include "slider.h"
+
+/*
+ * Ordinary least squares fits of `y` on the columns of `x`, plus an
+ * intercept, over a sliding window.
+ *
+ * A fit only needs the sufficient statistics of its window: the number of
+ * observations, the means of `x` and `y`, and their matrix of co-moments
+ * (sums of cross products of the deviations from the means). These merge
+ * exactly, without ever subtracting an element back out, which would cancel
+ * catastrophically on the large, nearly equal sums of wide windows.
+ *
+ * The window is kept as two stacks. Elements entering the window are merged
+ * into the statistics of the back stack. When the front of the window moves
+ * past the start of the back stack, the back stack is flipped into the front
+ * stack, which holds the statistics of every suffix of its elements. Each
+ * element is merged into each stack once, so a window costs amortized
+ * `O(p^2)`, regardless of its width, and solving the normal equations costs
+ * `O(p^3)`.
+ *
+ * The window only moves forwards, see `window-position.h`. Elements leaving
+ * the window are never taken out of a stack, they are skipped by reading the
+ * front stack at the suffix that starts the window. Empty windows leave both
+ * stacks as they are.
+ */
+struct window_lm {
+  SEXP values;
+  const double* p_values;
+  R_xlen_t size;
+
+  int n_predictors;
+  int n_vars;
+  int stride;
+
+  // Statistics of `[flip, end)`
+  double* p_back;
+
+  // Statistics of `[base + k, flip)` at `p_front + k * stride`
+  double* p_front;
+  R_xlen_t front_capacity;
+
+  double* p_merged;
+  double* p_row;
+  double* p_work;
+
+  R_xlen_t base;
+  R_xlen_t flip;
+  R_xlen_t begin;
+  R_xlen_t end;
+  R_xlen_t n_missing;
+
+  bool na_rm;
+};
+
+#define PROTECT_WINDOW_LM(p_lm, p_n) do {  \
+  PROTECT((p_lm)->values);                 \
+  *(p_n) += 1;                             \
+} while(0)
+
+// Intercept, slopes, R squared, and residual standard deviation
+#define WINDOW_LM_N_FIT(n_predictors) ((n_predictors) + 3)
+
+struct window_lm new_window_lm(SEXP y, SEXP x, bool na_rm);
+
+void window_lm_fit(struct window_lm* p_lm, R_xlen_t begin, R_xlen_t end, double* p_fit);
+
+#endif
@@ -0,0 +1,283 @@
+#include "slider.h"
+#include "utils.h"
+
+/*
+ * Window plans hold the resolved windows of an index, so that they can be
+ * shared by any number of calls without ranking the index again.
+ *
+ * The windows of each group of peers are stored as ranks in a canonical
+ * space that only depends on the number of peer groups, `m`. Peer group `p`
+ * has rank `2p + 1`, and the gap just before it has rank `2p`, so `2m` is
+ * the gap after the last one. A start that falls between two values of the
+ * index gets the rank of the gap, which keeps windows that select nothing,
+ * and windows that reach past either end of the index, exactly as they were
+ * for the completeness checks. The ranks of the index itself are implied.
+ *
+ * Starts and stops never decrease along an index, so they are stored as the
+ * differences between consecutive ranks in an unsigned LEB128 varint
+ * encoding, along with the peer sizes. Windows of steady width mostly move
+ * by a rank or two at a time, which takes a single byte rather than four.
+ */
+
+#define WINDOW_PLAN_MAX_PEERS ((INT_MAX - 1) / 2)
+
+static R_xlen_t varint_size(uint32_t value) {
+  R_xlen_t size = 1;
+
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+
+  return size;
+}
+
+static inline unsigned char* varint_write(unsigned char* p_out, uint32_t value) {
+  while (value >= 0x80) {
+    *p_out++ = (unsigned char) (value | 0x80);
+    value >>= 7;
+  }
+
+  *p_out++ = (unsigned char) value;
+  return p_out;
+}
+
+// Plans are ordinary lists that can be modified, or saved and loaded, so
+// nothing read from them is trusted
+static void stop_corrupt_window_plan(const char* why) {
+  Rf_errorcall(R_NilValue, "Corrupt window plan: %s.", why);
+}
+
+// A `uint32_t` takes at most 5 bytes, the last of which holds its top 4 bits
+static inline const unsigned char* varint_read(const unsigned char* p_x,
+                                               const unsigned char* p_end,
+                                               uint32_t* p_value) {
+  uint32_t value = 0;
+  int shift = 0;
+
+  while (true) {
+    if (p_x == p_end) {
+      stop_corrupt_window_plan("a value runs past the end of its buffer");
+    }
+
+    const unsigned char byte = *p_x++;
+
+    if (shift == 28 && byte > 0x0F) {
+      stop_corrupt_window_plan("a value is longer than 32 bits");
+    }
+
+    value |= (uint32_t) (byte & 0x7F) << shift;
+
+    if (!(byte & 0x80)) {
+      break;
+    }
+
+    shift += 7;
+  }
+
+  *p_value = value;
+  return p_x;
+}
+
+// Varints of the values of `p_x`, or of the differences between consecutive
+// values when `deltas` is set, which requires them to never decrease
+static SEXP varint_encode(const int* p_x, R_xlen_t size, bool deltas) {
+  R_xlen_t n_bytes = 0;
+  int previous = 0;
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    if (p_x[i] < previous) {
+      Rf_errorcall(R_NilValue, "Internal error: Window plan values must be ascending.");
+    }
+
+    n_bytes += varint_size((uint32_t) (p_x[i] - previous));
+    previous = deltas ? p_x[i] : 0;
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(RAWSXP, n_bytes));
+  unsigned char* p_out = RAW(out);
+
+  previous = 0;
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    p_out = varint_write(p_out, (uint32_t) (p_x[i] - previous));
+    previous = deltas ? p_x[i] : 0;
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// Decodes `size` values that must each fall in `[min, max]`. With `deltas`,
+// the values are ascending by construction, so checking `max` is enough to
+// keep their sum from overflowing.
+static SEXP varint_decode(SEXP x, R_xlen_t size, bool deltas, int min, int max) {
+  if (TYPEOF(x) != RAWSXP) {
+    stop_corrupt_window_plan("its windows must be raw vectors");
+  }
+
+  const unsigned char* p_x = RAW_RO(x);
+  const unsigned char* p_end = p_x + Rf_xlength(x);
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, size));
+  int* p_out = INTEGER(out);
+
+  int previous = 0;
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    uint32_t value;
+    p_x = varint_read(p_x, p_end, &value);
+
+    if (value > (uint32_t) (max - previous) || previous + (int) value < min) {
+      stop_corrupt_window_plan("a value is out of range");
+    }
+
+    p_out[i] = previous + (int) value;
+    previous = deltas ? p_out[i] : 0;
+  }
+
+  if (p_x != p_end) {
+    stop_corrupt_window_plan("a buffer holds more values than there are peer groups");
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+// Canonical ranks of `starts`, which are ranked along with the ascending ranks
+// of the peer groups, `p_i`. With the cursor moving forwards only, this is a
+// single merge.
+static void window_plan_starts(const int* p_i, int m, const int* p_starts, int* p_out) {
+  int p = 0;
+
+  for (int k = 0; k < m; ++k) {
+    const int start = p_starts[k];
+
+    while (p < m && p_i[p] < start) {
+      ++p;
+    }
+
+    p_out[k] = (p < m && p_i[p] == start) ? 2 * p + 1 : 2 * p;
+  }
+}
+
+static void window_plan_stops(const int* p_i, int m, const int* p_stops, int* p_out) {
+  int q = -1;
+
+  for (int k = 0; k < m; ++k) {
+    const int stop = p_stops[k];
+
+    while (q + 1 < m && p_i[q + 1] <= stop) {
+      ++q;
+    }
+
+    p_out[k] = (q >= 0 && p_i[q] == stop) ? 2 * q + 1 : 2 * q + 2;
+  }
+}
+
+// [[ register() ]]
+SEXP slider_window_plan_encode(SEXP i, SEXP starts, SEXP stops, SEXP peer_sizes) {
+  const R_xlen_t size = Rf_xlength(i);
+
+  if (size > WINDOW_PLAN_MAX_PEERS) {
+    Rf_errorcall(R_NilValue, "A window plan can hold at most %i unique index values.", WINDOW_PLAN_MAX_PEERS);
+  }
+
+  const int m = (int) size;
+  const int* p_i = INTEGER_RO(i);
+
+  int* p_ranks = (int*) R_alloc(m, sizeof(int));
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 3));
+
+  SET_VECTOR_ELT(out, 0, varint_encode(INTEGER_RO(peer_sizes), m, false));
+
+  // Unbounded starts and stops stay `NULL`
+  if (starts != R_NilValue) {
+    window_plan_starts(p_i, m, INTEGER_RO(starts), p_ranks);
+    SET_VECTOR_ELT(out, 1, varint_encode(p_ranks, m, true));
+  }
+
+  if (stops != R_NilValue) {
+    window_plan_stops(p_i, m, INTEGER_RO(stops), p_ranks);
+    SET_VECTOR_ELT(out, 2, varint_encode(p_ranks, m, true));
+  }
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 3));
+  SET_STRING_ELT(names, 0, Rf_mkChar("peer_sizes"));
+  SET_STRING_ELT(names, 1, Rf_mkChar("starts"));
+  SET_STRING_ELT(names, 2, Rf_mkChar("stops"));
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  UNPROTECT(2);
+  return out;
+}
+
+static int window_plan_count(SEXP x, int max, const char* why) {
+  if (TYPEOF(x) != INTSXP || Rf_xlength(x) != 1) {
+    stop_corrupt_window_plan(why);
+  }
+
+  const int out = r_scalar_int_get(x);
+
+  if (out == NA_INTEGER || out < 0 || out > max) {
+    stop_corrupt_window_plan(why);
+  }
+
+  return out;
+}
+
+// Decodes a plan into the `i`, `starts`, `stops`, and `peer_sizes` that the
+// index functions expect from `slide_index_info()`
+// [[ register() ]]
+SEXP slider_window_plan_decode(SEXP peer_sizes, SEXP starts, SEXP stops, SEXP n_peers, SEXP size) {
+  const int m = window_plan_count(n_peers, WINDOW_PLAN_MAX_PEERS, "`n_peers` must be a count of peer groups");
+  const int n = window_plan_count(size, INT_MAX, "`size` must be the size of its index");
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 4));
+
+  SEXP i = Rf_allocVector(INTSXP, m);
+  SET_VECTOR_ELT(out, 0, i);
+  int* p_i = INTEGER(i);
+
+  for (int p = 0; p < m; ++p) {
+    p_i[p] = 2 * p + 1;
+  }
+
+  // The canonical ranks of starts and stops lie in `[0, 2m]`
+  if (starts != R_NilValue) {
+    SET_VECTOR_ELT(out, 1, varint_decode(starts, m, true, 0, 2 * m));
+  }
+
+  if (stops != R_NilValue) {
+    SET_VECTOR_ELT(out, 2, varint_decode(stops, m, true, 0, 2 * m));
+  }
+
+  SEXP sizes = varint_decode(peer_sizes, m, false, 1, n);
+  SET_VECTOR_ELT(out, 3, sizes);
+
+  const int* p_sizes = INTEGER_RO(sizes);
+  int64_t total = 0;
+
+  for (int p = 0; p < m; ++p) {
+    total += p_sizes[p];
+  }
+
+  if (total != n) {
+    stop_corrupt_window_plan("the sizes of its peer groups must sum to `size`");
+  }
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 4));
+  SET_STRING_ELT(names, 0, Rf_mkChar("i"));
+  SET_STRING_ELT(names, 1, Rf_mkChar("starts"));
+  SET_STRING_ELT(names, 2, Rf_mkChar("stops"));
+  SET_STRING_ELT(names, 3, Rf_mkChar("peer_sizes"));
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  UNPROTECT(2);
+  return out;
+}
+
+#undef WINDOW_PLAN_MAX_PEERS
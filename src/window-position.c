@@ -0,0 +1,230 @@
+#include "window-position.h"
+#include "utils.h"
+#include "align.h"
+
+static SEXP wedge_allocate(R_xlen_t capacity);
+static void wedge_set_data(struct wedge* p_wedge, SEXP data, R_xlen_t capacity);
+
+/*
+ * `x` must be a double, integer, or logical vector. Integer and logical
+ * values are converted to double one chunk at a time as they are read.
+ */
+// [[ include("window-position.h") ]]
+struct wedge new_wedge(SEXP x, bool max, bool na_rm) {
+  struct wedge wedge;
+
+  wedge.x = x;
+  wedge.size = Rf_xlength(x);
+
+  wedge.max = max;
+  wedge.na_rm = na_rm;
+
+  wedge.data = PROTECT(wedge_allocate(WEDGE_INITIAL_CAPACITY));
+  wedge_set_data(&wedge, wedge.data, WEDGE_INITIAL_CAPACITY);
+  wedge.head = 0;
+  wedge.n = 0;
+
+  // Doubles first, so the integers that follow are aligned too
+  wedge.chunk = PROTECT(aligned_allocate(
+    WEDGE_CHUNK_SIZE,
+    sizeof(double) + sizeof(int),
+    sizeof(double)
+  ));
+  wedge.p_chunk = (double*) aligned_void_deref(wedge.chunk, sizeof(double));
+  wedge.p_chunk_int = (int*) (wedge.p_chunk + WEDGE_CHUNK_SIZE);
+  wedge.chunk_begin = 0;
+  wedge.chunk_end = 0;
+
+  wedge.next = 0;
+  wedge.last_missing = -1;
+
+  UNPROTECT(2);
+  return wedge;
+}
+
+// Values first, then positions. The alignment of `double` and `R_xlen_t`
+// always divides the size of a `double`.
+static SEXP wedge_allocate(R_xlen_t capacity) {
+  return aligned_allocate(capacity, sizeof(double) + sizeof(R_xlen_t), sizeof(double));
+}
+
+static void wedge_set_data(struct wedge* p_wedge, SEXP data, R_xlen_t capacity) {
+  p_wedge->p_values = (double*) aligned_void_deref(data, sizeof(double));
+  p_wedge->p_positions = (R_xlen_t*) (p_wedge->p_values + capacity);
+  p_wedge->capacity = capacity;
+}
+
+// -----------------------------------------------------------------------------
+
+static inline R_xlen_t wedge_slot(const struct wedge* p_wedge, R_xlen_t i) {
+  i += p_wedge->head;
+  return i >= p_wedge->capacity ? i - p_wedge->capacity : i;
+}
+
+static void wedge_grow(struct wedge* p_wedge) {
+  const R_xlen_t n = p_wedge->n;
+  const R_xlen_t capacity = p_wedge->capacity * 2;
+
+  SEXP data = PROTECT(wedge_allocate(capacity));
+  double* p_values = (double*) aligned_void_deref(data, sizeof(double));
+  R_xlen_t* p_positions = (R_xlen_t*) (p_values + capacity);
+
+  // Unwrap the ring buffer while copying
+  for (R_xlen_t i = 0; i < n; ++i) {
+    const R_xlen_t slot = wedge_slot(p_wedge, i);
+    p_values[i] = p_wedge->p_values[slot];
+    p_positions[i] = p_wedge->p_positions[slot];
+  }
+
+  REPROTECT(p_wedge->data = data, p_wedge->data_pi);
+  wedge_set_data(p_wedge, data, capacity);
+  p_wedge->head = 0;
+
+  UNPROTECT(1);
+}
+
+static void wedge_load_chunk(struct wedge* p_wedge, R_xlen_t begin) {
+  const R_xlen_t n = min_size(p_wedge->size - begin, WEDGE_CHUNK_SIZE);
+
+  SEXP x = p_wedge->x;
+  double* p_chunk = p_wedge->p_chunk;
+
+  if (TYPEOF(x) == REALSXP) {
+    r_vec_get_region(x, begin, n, p_chunk);
+  } else {
+    int* p_chunk_int = p_wedge->p_chunk_int;
+    r_vec_get_region(x, begin, n, p_chunk_int);
+
+    for (R_xlen_t i = 0; i < n; ++i) {
+      const int elt = p_chunk_int[i];
+      p_chunk[i] = elt == NA_INTEGER ? NA_REAL : (double) elt;
+    }
+  }
+
+  p_wedge->chunk_begin = begin;
+  p_wedge->chunk_end = begin + n;
+}
+
+static inline double wedge_read(struct wedge* p_wedge, R_xlen_t i) {
+  if (i >= p_wedge->chunk_end) {
+    wedge_load_chunk(p_wedge, i);
+  }
+  return p_wedge->p_chunk[i - p_wedge->chunk_begin];
+}
+
+static void wedge_push(struct wedge* p_wedge, R_xlen_t position) {
+  const double value = wedge_read(p_wedge, position);
+
+  if (isnan(value)) {
+    p_wedge->last_missing = position;
+    return;
+  }
+
+  const bool max = p_wedge->max;
+  const double* p_values = p_wedge->p_values;
+
+  // Strict comparisons keep earlier ties in front, so ties resolve to the
+  // first position like `which.min()` and `which.max()`
+  while (p_wedge->n > 0) {
+    const double back = p_values[wedge_slot(p_wedge, p_wedge->n - 1)];
+    const bool beaten = max ? back < value : back > value;
+
+    if (!beaten) {
+      break;
+    }
+
+    --p_wedge->n;
+  }
+
+  if (p_wedge->n == p_wedge->capacity) {
+    wedge_grow(p_wedge);
+  }
+
+  const R_xlen_t slot = wedge_slot(p_wedge, p_wedge->n);
+  p_wedge->p_values[slot] = value;
+  p_wedge->p_positions[slot] = position;
+  ++p_wedge->n;
+}
+
+/*
+ * With `na_rm = FALSE`, a window holding a missing value has no position.
+ * Missing values are never queued, we only need to know whether the last one
+ * seen is still inside the window.
+ */
+// [[ include("window-position.h") ]]
+R_xlen_t wedge_locate(void* p_wedge, R_xlen_t begin, R_xlen_t end) {
+  struct wedge* p_wedge_ = (struct wedge*) p_wedge;
+
+  while (p_wedge_->next < end) {
+    wedge_push(p_wedge_, p_wedge_->next);
+    ++p_wedge_->next;
+  }
+
+  while (p_wedge_->n > 0 && p_wedge_->p_positions[p_wedge_->head] < begin) {
+    p_wedge_->head = wedge_slot(p_wedge_, 1);
+    --p_wedge_->n;
+  }
+
+  if (!p_wedge_->na_rm && p_wedge_->last_missing >= begin) {
+    return -1;
+  }
+
+  if (p_wedge_->n == 0) {
+    return -1;
+  }
+
+  return p_wedge_->p_positions[p_wedge_->head];
+}
+
+// -----------------------------------------------------------------------------
+
+// Without missing value removal, the first and last positions come from the
+// window bounds alone
+
+// [[ include("window-position.h") ]]
+R_xlen_t window_first(void* p_engine, R_xlen_t begin, R_xlen_t end) {
+  return begin;
+}
+
+// [[ include("window-position.h") ]]
+R_xlen_t window_last(void* p_engine, R_xlen_t begin, R_xlen_t end) {
+  return end - 1;
+}
+
+/*
+ * Every position in `[begin, cursor)` is known to be missing, so the search
+ * resumes where the previous window left off.
+ */
+// [[ include("window-position.h") ]]
+R_xlen_t window_first_complete(void* p_cursor, R_xlen_t begin, R_xlen_t end) {
+  struct first_complete_cursor* p_cursor_ = (struct first_complete_cursor*) p_cursor;
+  const struct lgl_bitmap* p_missing = p_cursor_->p_missing;
+
+  R_xlen_t position = max_size(p_cursor_->position, begin);
+
+  while (position < end && lgl_bitmap_is_na(p_missing, position)) {
+    ++position;
+  }
+
+  p_cursor_->position = position;
+
+  return position < end ? position : -1;
+}
+
+// Tracks the last non-missing position before `end`, which is only part of
+// the window if it isn't before `begin`
+// [[ include("window-position.h") ]]
+R_xlen_t window_last_complete(void* p_cursor, R_xlen_t begin, R_xlen_t end) {
+  struct last_complete_cursor* p_cursor_ = (struct last_complete_cursor*) p_cursor;
+  const struct lgl_bitmap* p_missing = p_cursor_->p_missing;
+
+  for (R_xlen_t i = p_cursor_->scanned; i < end; ++i) {
+    if (!lgl_bitmap_is_na(p_missing, i)) {
+      p_cursor_->position = i;
+    }
+  }
+
+  p_cursor_->scanned = max_size(p_cursor_->scanned, end);
+
+  return p_cursor_->position >= begin ? p_cursor_->position : -1;
+}
@@ -0,0 +1,115 @@
+#ifndef SLIDER_WINDOW_POSITION
+#define SLIDER_WINDOW_POSITION
+
+#include "slider.h"
+#include "bitmap.h"
+
+/*
+ * Engines that locate a single position in each window, rather than
+ * aggregating over it. They rely on the window bounds never moving backwards
+ * from one non-empty window to the next, which holds for both `slide_*()` and
+ * `slide_index_*()` windows. This way each element of `x` is only visited a
+ * constant number of times overall, whatever the window width. The other
+ * engines that move their window forwards one element at a time rely on the
+ * same property.
+ *
+ * Positions are 0-based. `-1` signals that there is no such position.
+ */
+typedef R_xlen_t (*window_position_fn)(void* p_engine,
+                                       R_xlen_t begin,
+                                       R_xlen_t end);
+
+// Number of elements pulled at once from `x`, so that unmaterialized ALTREP
+// vectors are never copied in full
+#define WEDGE_CHUNK_SIZE 4096
+
+#define WEDGE_INITIAL_CAPACITY 64
+
+/*
+ * A monotonic wedge, i.e. a double ended queue of the candidate positions for
+ * the minimum (or maximum) of the current window. Values are kept in
+ * increasing (or decreasing) order, so the front is always the answer. A new
+ * value evicts every candidate behind it that it beats, and candidates leave
+ * from the front once they fall out of the window.
+ *
+ * The queue is a ring buffer that doubles in size when it is full, so it only
+ * grows to the largest number of candidates held at once.
+ */
+struct wedge {
+  SEXP x;
+  R_xlen_t size;
+
+  bool max;
+  bool na_rm;
+
+  SEXP data;
+  PROTECT_INDEX data_pi;
+  double* p_values;
+  R_xlen_t* p_positions;
+  R_xlen_t capacity;
+  R_xlen_t head;
+  R_xlen_t n;
+
+  SEXP chunk;
+  double* p_chunk;
+  int* p_chunk_int;
+  R_xlen_t chunk_begin;
+  R_xlen_t chunk_end;
+
+  R_xlen_t next;
+  R_xlen_t last_missing;
+};
+
+#define PROTECT_WEDGE(p_wedge, p_n) do {                      \
+  PROTECT_WITH_INDEX((p_wedge)->data, &(p_wedge)->data_pi);   \
+  PROTECT((p_wedge)->chunk);                                  \
+  *(p_n) += 2;                                                \
+} while(0)
+
+struct wedge new_wedge(SEXP x, bool max, bool na_rm);
+R_xlen_t wedge_locate(void* p_wedge, R_xlen_t begin, R_xlen_t end);
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Cursors for the first and last non-missing positions. `missing` comes from
+ * `new_missing_bitmap()`.
+ */
+struct first_complete_cursor {
+  const struct lgl_bitmap* p_missing;
+  R_xlen_t position;
+};
+
+struct last_complete_cursor {
+  const struct lgl_bitmap* p_missing;
+  R_xlen_t scanned;
+  R_xlen_t position;
+};
+
+static inline struct first_complete_cursor new_first_complete_cursor(const struct lgl_bitmap* p_missing) {
+  struct first_complete_cursor cursor = { .p_missing = p_missing, .position = 0 };
+  return cursor;
+}
+
+static inline struct last_complete_cursor new_last_complete_cursor(const struct lgl_bitmap* p_missing) {
+  struct last_complete_cursor cursor = { .p_missing = p_missing, .scanned = 0, .position = -1 };
+  return cursor;
+}
+
+R_xlen_t window_first(void* p_engine, R_xlen_t begin, R_xlen_t end);
+R_xlen_t window_last(void* p_engine, R_xlen_t begin, R_xlen_t end);
+R_xlen_t window_first_complete(void* p_cursor, R_xlen_t begin, R_xlen_t end);
+R_xlen_t window_last_complete(void* p_cursor, R_xlen_t begin, R_xlen_t end);
+
+// -----------------------------------------------------------------------------
+
+// 1-based position for R. Positions past `INT_MAX` can only come from long
+// vectors, and can't be represented.
+static inline int window_position_as_int(R_xlen_t position) {
+  if (position < 0 || position >= INT_MAX) {
+    return NA_INTEGER;
+  }
+  return (int) (position + 1);
+}
+
+#endif
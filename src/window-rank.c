@@ -0,0 +1,513 @@
+#include "window-rank.h"
+#include "utils.h"
+#include "align.h"
+#include "summary-core.h"
+
+static int compare_double(const void* x, const void* y);
+static R_xlen_t sorted_locate(const double* p_sorted, R_xlen_t n, double value);
+
+/*
+ * `x` must be a double vector. It is pulled in full once to compute the dense
+ * ranks, so unmaterialized ALTREP vectors are copied but never materialized.
+ * The segment tree of sums is only allocated with `sums`.
+ */
+// [[ include("window-rank.h") ]]
+struct window_rank new_window_rank(SEXP x, bool na_rm, bool sums) {
+  const R_xlen_t size = Rf_xlength(x);
+
+  SEXP values = PROTECT(Rf_allocVector(REALSXP, size));
+  double* p_values = REAL(values);
+  r_vec_get_region(x, 0, size, p_values);
+
+  SEXP sorted = PROTECT(Rf_allocVector(REALSXP, size));
+  double* p_sorted = REAL(sorted);
+  R_xlen_t n_sorted = 0;
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    const double elt = p_values[i];
+
+    if (!isnan(elt)) {
+      p_sorted[n_sorted] = elt;
+      ++n_sorted;
+    }
+  }
+
+  qsort(p_sorted, n_sorted, sizeof(double), compare_double);
+
+  // Collapse ties, `-0` and `0` included
+  R_xlen_t n_unique = 0;
+
+  for (R_xlen_t i = 0; i < n_sorted; ++i) {
+    if (n_unique == 0 || p_sorted[i] != p_sorted[n_unique - 1]) {
+      p_sorted[n_unique] = p_sorted[i];
+      ++n_unique;
+    }
+  }
+
+  SEXP ids = PROTECT(aligned_allocate(size, sizeof(R_xlen_t), sizeof(R_xlen_t)));
+  R_xlen_t* p_ids = (R_xlen_t*) aligned_void_deref(ids, sizeof(R_xlen_t));
+
+  for (R_xlen_t i = 0; i < size; ++i) {
+    const double elt = p_values[i];
+    p_ids[i] = isnan(elt) ? -1 : sorted_locate(p_sorted, n_unique, elt);
+  }
+
+  // 1-based, slot `0` is unused
+  SEXP tree = PROTECT(aligned_allocate(n_unique + 1, sizeof(R_xlen_t), sizeof(R_xlen_t)));
+  R_xlen_t* p_tree = (R_xlen_t*) aligned_void_deref(tree, sizeof(R_xlen_t));
+  memset(p_tree, 0, (n_unique + 1) * sizeof(R_xlen_t));
+
+  R_xlen_t select_step = 1;
+
+  while (select_step <= n_unique / 2) {
+    select_step *= 2;
+  }
+
+  SEXP sums_tree = R_NilValue;
+  long double* p_sums = NULL;
+  R_xlen_t n_leaves = 0;
+
+  if (sums) {
+    n_leaves = select_step < n_unique ? 2 * select_step : select_step;
+    sums_tree = aligned_allocate(2 * n_leaves, sizeof(long double), align_of_long_double());
+    p_sums = (long double*) aligned_void_deref(sums_tree, align_of_long_double());
+
+    for (R_xlen_t i = 0; i < 2 * n_leaves; ++i) {
+      p_sums[i] = 0;
+    }
+  }
+  PROTECT(sums_tree);
+
+  struct window_rank rank = {
+    .ids = ids,
+    .p_ids = p_ids,
+    .values = sorted,
+    .p_values = p_sorted,
+    .tree = tree,
+    .p_tree = p_tree,
+    .n_unique = n_unique,
+    .select_step = select_step,
+    .sums = sums_tree,
+    .p_sums = p_sums,
+    .n_leaves = n_leaves,
+    .begin = 0,
+    .end = 0,
+    .n_missing = 0,
+    .na_rm = na_rm
+  };
+
+  UNPROTECT(5);
+  return rank;
+}
+
+static int compare_double(const void* x, const void* y) {
+  const double x_ = *((const double*) x);
+  const double y_ = *((const double*) y);
+  return (x_ > y_) - (x_ < y_);
+}
+
+// Position of `value`, which is known to be in `p_sorted`
+static R_xlen_t sorted_locate(const double* p_sorted, R_xlen_t n, double value) {
+  R_xlen_t lo = 0;
+  R_xlen_t hi = n;
+
+  while (lo < hi) {
+    const R_xlen_t mid = lo + (hi - lo) / 2;
+
+    if (p_sorted[mid] < value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+// -----------------------------------------------------------------------------
+
+static inline void rank_tree_add(struct window_rank* p_rank, R_xlen_t id, R_xlen_t delta) {
+  R_xlen_t* p_tree = p_rank->p_tree;
+  const R_xlen_t n = p_rank->n_unique;
+
+  for (R_xlen_t i = id + 1; i <= n; i += i & -i) {
+    p_tree[i] += delta;
+  }
+}
+
+// Number of window elements with a dense rank below `id`
+static inline R_xlen_t rank_tree_count_below(const struct window_rank* p_rank, R_xlen_t id) {
+  const R_xlen_t* p_tree = p_rank->p_tree;
+  R_xlen_t out = 0;
+
+  for (R_xlen_t i = id; i > 0; i -= i & -i) {
+    out += p_tree[i];
+  }
+
+  return out;
+}
+
+// Dense rank of the `k`-th smallest element of the window, 0-based. Descends
+// the tree from the largest power of 2, skipping over the subtrees holding at
+// most `k` elements.
+static inline R_xlen_t rank_tree_select(const struct window_rank* p_rank, R_xlen_t k) {
+  const R_xlen_t* p_tree = p_rank->p_tree;
+  const R_xlen_t n = p_rank->n_unique;
+
+  R_xlen_t id = 0;
+
+  for (R_xlen_t step = p_rank->select_step; step > 0; step /= 2) {
+    const R_xlen_t next = id + step;
+
+    if (next <= n && p_tree[next] <= k) {
+      id = next;
+      k -= p_tree[next];
+    }
+  }
+
+  return id;
+}
+
+static inline double window_rank_select(const struct window_rank* p_rank, R_xlen_t k) {
+  return p_rank->p_values[rank_tree_select(p_rank, k)];
+}
+
+// Number of window elements with a dense rank of `id`
+static inline R_xlen_t rank_tree_count(const struct window_rank* p_rank, R_xlen_t id) {
+  return rank_tree_count_below(p_rank, id + 1) - rank_tree_count_below(p_rank, id);
+}
+
+// Recomputes the leaf of `id` from its count, and its ancestors from their
+// children. Infinite values are left out, they are counted separately.
+static inline void sums_tree_update(struct window_rank* p_rank, R_xlen_t id) {
+  long double* p_sums = p_rank->p_sums;
+  const double value = p_rank->p_values[id];
+
+  R_xlen_t node = p_rank->n_leaves + id;
+
+  p_sums[node] = R_FINITE(value) ? (long double) rank_tree_count(p_rank, id) * value : 0;
+
+  for (node /= 2; node > 0; node /= 2) {
+    p_sums[node] = p_sums[2 * node] + p_sums[2 * node + 1];
+  }
+}
+
+// Sum of the window values with a dense rank in `[from, to)`
+static inline long double sums_tree_range(const struct window_rank* p_rank, R_xlen_t from, R_xlen_t to) {
+  const long double* p_sums = p_rank->p_sums;
+  long double out = 0;
+
+  for (from += p_rank->n_leaves, to += p_rank->n_leaves; from < to; from /= 2, to /= 2) {
+    if (from & 1) {
+      out += p_sums[from++];
+    }
+    if (to & 1) {
+      out += p_sums[--to];
+    }
+  }
+
+  return out;
+}
+
+static inline void window_rank_update(struct window_rank* p_rank, R_xlen_t position, R_xlen_t delta) {
+  const R_xlen_t id = p_rank->p_ids[position];
+
+  if (id < 0) {
+    p_rank->n_missing += delta;
+    return;
+  }
+
+  rank_tree_add(p_rank, id, delta);
+
+  if (p_rank->p_sums != NULL) {
+    sums_tree_update(p_rank, id);
+  }
+}
+
+static inline void window_rank_advance(struct window_rank* p_rank, R_xlen_t begin, R_xlen_t end) {
+  while (p_rank->end < end) {
+    window_rank_update(p_rank, p_rank->end, 1);
+    ++p_rank->end;
+  }
+
+  while (p_rank->begin < begin) {
+    window_rank_update(p_rank, p_rank->begin, -1);
+    ++p_rank->begin;
+  }
+}
+
+/*
+ * Average rank of `x[position]` within `[begin, end)`. When `position` is
+ * outside of the window, it is ranked as if it were added to the window.
+ */
+// [[ include("window-rank.h") ]]
+double window_rank_locate(struct window_rank* p_rank,
+                          R_xlen_t begin,
+                          R_xlen_t end,
+                          R_xlen_t position) {
+  const R_xlen_t id = p_rank->p_ids[position];
+
+  if (id < 0) {
+    return NA_REAL;
+  }
+
+  const bool in_window = begin <= position && position < end;
+
+  // Empty windows leave the tree as is, the next window picks up from the
+  // previous non-empty one
+  if (begin >= end) {
+    return 1;
+  }
+
+  window_rank_advance(p_rank, begin, end);
+
+  if (!p_rank->na_rm && p_rank->n_missing > 0) {
+    return NA_REAL;
+  }
+
+  const R_xlen_t n_below = rank_tree_count_below(p_rank, id);
+  const R_xlen_t n_equal = rank_tree_count_below(p_rank, id + 1) - n_below;
+
+  // The tied values take up positions `n_below + 1` through
+  // `n_below + n_equal`, plus one when `x[position]` joins them
+  const R_xlen_t n_tied = in_window ? n_equal : n_equal + 1;
+
+  return n_below + (n_tied + 1) / 2.0;
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * The absolute deviations from the median `m` of the `n` sorted elements `s`
+ * of a window are the merge of two increasing runs: `m - s[n_lower - 1 - j]`
+ * over the elements at or below the lower middle one, and
+ * `s[n_lower + j] - m` over the others. Both runs are read through order
+ * statistics of the tree, so the deviations are never materialized.
+ */
+struct mad_runs {
+  const struct window_rank* p_rank;
+  double median;
+  R_xlen_t n_lower;
+  R_xlen_t n_upper;
+};
+
+static inline double mad_runs_lower(const struct mad_runs* p_runs, R_xlen_t j) {
+  return p_runs->median - window_rank_select(p_runs->p_rank, p_runs->n_lower - 1 - j);
+}
+
+static inline double mad_runs_upper(const struct mad_runs* p_runs, R_xlen_t j) {
+  return window_rank_select(p_runs->p_rank, p_runs->n_lower + j) - p_runs->median;
+}
+
+/*
+ * `k`-th smallest deviation, 0-based. Binary searches for the number of the
+ * `k + 1` smallest deviations that come from the lower run, which is the
+ * first count where the next lower deviation is no smaller than the last
+ * upper one taken. Costs `O(log(n) * log(n_unique))`.
+ */
+static double mad_runs_select(const struct mad_runs* p_runs, R_xlen_t k) {
+  R_xlen_t lo = max_size(0, k + 1 - p_runs->n_upper);
+  R_xlen_t hi = min_size(k + 1, p_runs->n_lower);
+
+  while (lo < hi) {
+    const R_xlen_t mid = lo + (hi - lo) / 2;
+
+    if (mad_runs_lower(p_runs, mid) < mad_runs_upper(p_runs, k - mid)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  const R_xlen_t n_from_upper = k + 1 - lo;
+
+  if (lo == 0) {
+    return mad_runs_upper(p_runs, n_from_upper - 1);
+  }
+  if (n_from_upper == 0) {
+    return mad_runs_lower(p_runs, lo - 1);
+  }
+
+  return fmax(mad_runs_lower(p_runs, lo - 1), mad_runs_upper(p_runs, n_from_upper - 1));
+}
+
+// Like `median()`, the middle two values of even sizes are averaged
+static inline double window_rank_middle(R_xlen_t n, double lower, double upper) {
+  if (n % 2 == 1) {
+    return upper;
+  }
+
+  return (double) (((long double) lower + upper) / 2);
+}
+
+/*
+ * Median of `[begin, end)`, and the median of the absolute deviations from
+ * it, unscaled. Returns `false` when the window has no median, i.e. when it
+ * is empty, or when it has missing values that aren't removed. A non-finite
+ * median has a missing `p_mad`, like `mad()`.
+ */
+// [[ include("window-rank.h") ]]
+bool window_rank_mad(struct window_rank* p_rank,
+                     R_xlen_t begin,
+                     R_xlen_t end,
+                     double* p_median,
+                     double* p_mad) {
+  // Empty windows leave the tree as is, the next window picks up from the
+  // previous non-empty one
+  if (begin >= end) {
+    return false;
+  }
+
+  window_rank_advance(p_rank, begin, end);
+
+  if (!p_rank->na_rm && p_rank->n_missing > 0) {
+    return false;
+  }
+
+  const R_xlen_t n = rank_tree_count_below(p_rank, p_rank->n_unique);
+
+  if (n == 0) {
+    return false;
+  }
+
+  const R_xlen_t half = n / 2;
+
+  const double median = window_rank_middle(
+    n,
+    n % 2 == 1 ? 0 : window_rank_select(p_rank, half - 1),
+    window_rank_select(p_rank, half)
+  );
+
+  *p_median = median;
+
+  if (!R_FINITE(median)) {
+    *p_mad = NA_REAL;
+    return true;
+  }
+
+  const R_xlen_t n_lower = (n + 1) / 2;
+
+  const struct mad_runs runs = {
+    .p_rank = p_rank,
+    .median = median,
+    .n_lower = n_lower,
+    .n_upper = n - n_lower
+  };
+
+  *p_mad = window_rank_middle(
+    n,
+    n % 2 == 1 ? 0 : mad_runs_select(&runs, half - 1),
+    mad_runs_select(&runs, half)
+  );
+
+  return true;
+}
+
+// Number of the order statistics `[from, to)` of a window of `n` elements
+// that are among its first `n_head`, or its last `n_tail`
+static inline R_xlen_t order_overlap_head(R_xlen_t from, R_xlen_t to, R_xlen_t n_head) {
+  return max_size(0, min_size(to, n_head) - from);
+}
+static inline R_xlen_t order_overlap_tail(R_xlen_t from, R_xlen_t to, R_xlen_t n, R_xlen_t n_tail) {
+  return max_size(0, to - max_size(from, n - n_tail));
+}
+
+/*
+ * Mean of the order statistics `[from, to)` of a window of `n` elements.
+ * `-Inf` and `Inf` can only be the first and last distinct values, and are
+ * counted rather than summed. Otherwise, the elements of the first and last
+ * dense ranks of the range are multiplied out, and the ranks in between are
+ * summed from the segment tree, so no sums are subtracted.
+ */
+static double window_rank_order_mean(const struct window_rank* p_rank,
+                                     R_xlen_t n,
+                                     R_xlen_t from,
+                                     R_xlen_t to) {
+  const R_xlen_t n_unique = p_rank->n_unique;
+  const double* p_values = p_rank->p_values;
+
+  const R_xlen_t n_neg_inf = p_values[0] == R_NegInf ? rank_tree_count(p_rank, 0) : 0;
+  const R_xlen_t n_pos_inf = p_values[n_unique - 1] == R_PosInf ? rank_tree_count(p_rank, n_unique - 1) : 0;
+
+  const bool has_neg_inf = order_overlap_head(from, to, n_neg_inf) > 0;
+  const bool has_pos_inf = order_overlap_tail(from, to, n, n_pos_inf) > 0;
+
+  if (has_neg_inf && has_pos_inf) {
+    return R_NaN;
+  }
+  if (has_neg_inf) {
+    return R_NegInf;
+  }
+  if (has_pos_inf) {
+    return R_PosInf;
+  }
+
+  const R_xlen_t id_first = rank_tree_select(p_rank, from);
+  const R_xlen_t id_last = rank_tree_select(p_rank, to - 1);
+
+  long double sum;
+
+  if (id_first == id_last) {
+    sum = (long double) (to - from) * p_values[id_first];
+  } else {
+    const R_xlen_t n_first = rank_tree_count_below(p_rank, id_first + 1) - from;
+    const R_xlen_t n_last = to - rank_tree_count_below(p_rank, id_last);
+
+    sum =
+      (long double) n_first * p_values[id_first] +
+      sums_tree_range(p_rank, id_first + 1, id_last) +
+      (long double) n_last * p_values[id_last];
+  }
+
+  return (double) (sum / (to - from));
+}
+
+/*
+ * Mean of `[begin, end)` once the `floor(n * trim)` smallest and largest of
+ * its `n` elements are dropped, like `mean(trim = )`. A `trim` of `0.5` gives
+ * the median.
+ */
+// [[ include("window-rank.h") ]]
+double window_rank_trimmed_mean(struct window_rank* p_rank,
+                                R_xlen_t begin,
+                                R_xlen_t end,
+                                double trim) {
+  // Empty windows leave the tree as is, the next window picks up from the
+  // previous non-empty one
+  if (begin >= end) {
+    return R_NaN;
+  }
+
+  window_rank_advance(p_rank, begin, end);
+
+  if (!p_rank->na_rm && p_rank->n_missing > 0) {
+    return NA_REAL;
+  }
+
+  const R_xlen_t n = rank_tree_count_below(p_rank, p_rank->n_unique);
+
+  if (n == 0) {
+    return R_NaN;
+  }
+
+  if (trim >= 0.5) {
+    const R_xlen_t half = n / 2;
+
+    return window_rank_middle(
+      n,
+      n % 2 == 1 ? 0 : window_rank_select(p_rank, half - 1),
+      window_rank_select(p_rank, half)
+    );
+  }
+
+  const R_xlen_t n_trim = (R_xlen_t) floor(n * trim);
+
+  return window_rank_order_mean(p_rank, n, n_trim, n - n_trim);
+}
+
+// Value of `x[position]`, up to the sign of zeros, which are collapsed
+// [[ include("window-rank.h") ]]
+double window_rank_value(const struct window_rank* p_rank, R_xlen_t position) {
+  const R_xlen_t id = p_rank->p_ids[position];
+  return id < 0 ? NA_REAL : p_rank->p_values[id];
+}
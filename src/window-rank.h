@@ -0,0 +1,84 @@
+#ifndef SLIDER_WINDOW_RANK
+#define SLIDER_WINDOW_RANK
+
+#include "slider.h"
+
+/*
+ * Ranks a value within a sliding window of `x`, with the tie semantics of
+ * `rank(ties.method = "average")`.
+ *
+ * Every non-missing value of `x` is first mapped to its dense rank among all
+ * of the distinct values of `x`. A Fenwick tree over those ranks holds the
+ * number of window elements with each value, so inserting and erasing an
+ * element, counting the elements below or equal to a value, and selecting
+ * the `k`-th smallest element of the window, all take `O(log(n_unique))`.
+ *
+ * Order statistics also give the median of the window, and the median of the
+ * absolute deviations from it.
+ *
+ * With `sums`, a segment tree over the dense ranks also holds the sum of the
+ * finite window values of each node. Leaves are recomputed from their count
+ * and parents from their children on every update, rather than adding and
+ * subtracting values, so the sums don't drift as the window slides. The sum
+ * of any range of order statistics then takes `O(log(n_unique))`.
+ *
+ * The window only moves forwards, see `window-position.h`, so each element
+ * updates the counts of the tree once when it enters and once when it leaves.
+ */
+struct window_rank {
+  SEXP ids;
+  const R_xlen_t* p_ids;
+
+  // The distinct values of `x`, in increasing order
+  SEXP values;
+  const double* p_values;
+
+  SEXP tree;
+  R_xlen_t* p_tree;
+  R_xlen_t n_unique;
+
+  // Largest power of 2 that is at most `n_unique`
+  R_xlen_t select_step;
+
+  // Segment tree of sums, leaves start at `p_sums + n_leaves`. `NULL`
+  // without `sums`.
+  SEXP sums;
+  long double* p_sums;
+  R_xlen_t n_leaves;
+
+  R_xlen_t begin;
+  R_xlen_t end;
+  R_xlen_t n_missing;
+
+  bool na_rm;
+};
+
+#define PROTECT_WINDOW_RANK(p_rank, p_n) do {  \
+  PROTECT((p_rank)->ids);                      \
+  PROTECT((p_rank)->values);                   \
+  PROTECT((p_rank)->tree);                     \
+  PROTECT((p_rank)->sums);                     \
+  *(p_n) += 4;                                 \
+} while(0)
+
+struct window_rank new_window_rank(SEXP x, bool na_rm, bool sums);
+
+double window_rank_locate(struct window_rank* p_rank,
+                          R_xlen_t begin,
+                          R_xlen_t end,
+                          R_xlen_t position);
+
+bool window_rank_mad(struct window_rank* p_rank,
+                     R_xlen_t begin,
+                     R_xlen_t end,
+                     double* p_median,
+                     double* p_mad);
+
+double window_rank_trimmed_mean(struct window_rank* p_rank,
+                                R_xlen_t begin,
+                                R_xlen_t end,
+                                double trim);
+
+double window_rank_value(const struct window_rank* p_rank, R_xlen_t position);
+
+#endif